@@ -4,7 +4,8 @@ enable_testing()
 #
 #   calc_add_unit_test(<TARGET>)
 #
-# Adds an unit-test executable.
+# Adds an unit-test executable. Unit-tests that write files put them in the
+# directory CALC_TEMP_PATH, that is created in the build tree.
 #
 function(calc_add_unit_test TARGET)
     get_property(_LIBS GLOBAL PROPERTY CALC_TARGETS)
@@ -24,6 +25,9 @@ function(calc_add_unit_test TARGET)
 
     add_executable(${_ARG_NAME} "${_ARG_SOURCES}")
 
+    file(MAKE_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}/tmp")
+    target_compile_definitions(${_ARG_NAME} PRIVATE CALC_TEMP_PATH="${CMAKE_CURRENT_BINARY_DIR}/tmp")
+
     if(_ARG_DEPENDS)
         target_link_libraries(${_ARG_NAME} "${_ARG_DEPENDS}")
     endif()
@@ -81,6 +81,25 @@ CALC_INLINE void *CALC_STDCALL _check(void *const block, const char *const errMs
 #   define dim(T, N) (T *)ccalloc(N, sizeof(T))
 #endif // dim
 
+#ifndef crealloc
+/// @brief Changes the size of a block of memory in the dynamic heap,
+///        checking return value.
+/// @param P A pointer to the block of memory to resize.
+/// @param S The new number of bytes of the block.
+/// @return A pointer to the resized block of memory.
+#   define crealloc(P, S) _check(realloc((P), (S)), CALC_ALLOC_ERROR_MESSAGE)
+#endif // crealloc
+
+#ifndef redim
+/// @brief Changes the number of contiguous blocks of memory of the same
+///        dimension of the specified data type.
+/// @param T The type of the items.
+/// @param P A pointer to the items to resize.
+/// @param N The new number of items.
+/// @return A pointer to the resized items.
+#   define redim(T, P, N) (T *)crealloc((void *)(P), (N) * sizeof(T))
+#endif // redim
+
 /// @brief Frees a block of memory and returns a specified value.
 /// @param toFree Block of memory to free.
 /// @param retValue Value to return as result.
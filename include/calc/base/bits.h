@@ -318,7 +318,7 @@ typedef unsigned int uint32_t;
 
 #if (!defined UINT64_MIN || !defined UINT64_MAX)
 
-#if (CALC_C_STANDARD >= CALC_C_STANDARD_C99) || (CALC_PLATFORM_IS_MACOS && CALC_C_EXTENSIONS)
+#if (CALC_C_STANDARD >= CALC_C_STANDARD_C99) || CALC_C_EXTENSIONS
 /**
  * @brief       Unsigned 64-bit integer datatype.
  */
@@ -342,7 +342,7 @@ typedef uint32_t uint64_t;
  * @brief       This macro represents the minimum value representable with an
  *              64-bit unsigned integer.
  */
-#       define UINT64_MIN ((uint64_t)UINT32_MIN)
+#       define UINT64_MIN ((uint64_t)0)
 #   endif
 #endif
 
@@ -358,7 +358,7 @@ typedef uint32_t uint64_t;
  * @brief       This macro represents the maximum value representable with an
  *              64-bit unsigned integer.
  */
-#       define UINT64_MAX ((uint64_t)UINT32_MAX)
+#       define UINT64_MAX (~(uint64_t)0)
 #   endif
 #endif
 
@@ -171,6 +171,22 @@ CALC_INLINE size_t CALC_STDCALL fgetsiz(FILE *const stream) {
         return fsiz;
 }
 
+/**
+ * @brief       Checks if a file stream is connected to a terminal (an
+ *              interactive device), rather than to a file or a pipe.
+ * 
+ * @param       stream The file stream to check.
+ * @return      TRUE if the stream is a terminal, otherwise FALSE.
+ */
+CALC_INLINE bool_t CALC_STDCALL fisatty(FILE *const stream)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    return (bool_t)!!_isatty(_fileno(stream));
+#else
+    return (bool_t)!!isatty(fileno(stream));
+#endif
+}
+
 CALC_C_HEADER_END
 
 #endif /* CALC_BASE_FILE_H_ */
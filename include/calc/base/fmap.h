@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file        fmap.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc programming language project,
+ *              under the Apache License v2.0. See LICENSE file for license
+ *              informations.
+ *
+ * @version     1.1
+ *
+ * @brief       In this header are defined functions to map read-only, or to
+ *              load, the content of files in memory.
+ */
+
+#ifndef CALC_BASE_FMAP_H_
+#define CALC_BASE_FMAP_H_
+
+#include "calc/base/bool.h"
+#include "calc/base/byte.h"
+
+CALC_C_HEADER_BEGIN
+
+/**
+ * @brief       Maps read-only in memory the whole content of the regular file
+ *              specified by the path parameter. The mapped region is always
+ *              followed by a NUL byte, so it can be read as a NUL-terminated
+ *              sequence of bytes.
+ *
+ * @note        The file must not be truncated while it's mapped.
+ *
+ * @param       path The path to the file to map.
+ * @param       outSize A pointer to a variable in which store the size of the
+ *              file (in bytes), NUL byte excluded.
+ * @return      A pointer to the first byte of the mapped file, or NULL when the
+ *              file cannot be mapped (it doesn't exist, it's not a regular file
+ *              or memory mapping is not supported by the platform).
+ */
+CALC_EXTERN byte_t *CALC_STDCALL fmap(const char *const path, size_t *const outSize);
+
+/**
+ * @brief       Loads in memory the whole content of the regular file specified
+ *              by the path parameter, reading it with positioned reads after
+ *              advising the system to read ahead the file sequentially. Like
+ *              mapped files, the loaded content is always followed by a NUL
+ *              byte. Unlike fmap(...), every byte is read before returning,
+ *              so no page fault is left for the reader of the content. If
+ *              the file shrinks while it's loaded, the content ends where the
+ *              file ends.
+ *
+ * @param       path The path to the file to load.
+ * @param       outSize A pointer to a variable in which store the size of the
+ *              loaded content (in bytes), NUL byte excluded.
+ * @return      A pointer to the first byte of the loaded content, allocated on
+ *              the heap (it must be released with free), or NULL when the file
+ *              cannot be loaded (it doesn't exist, it's not a regular file or
+ *              a read fails).
+ */
+CALC_EXTERN byte_t *CALC_STDCALL fload(const char *const path, size_t *const outSize);
+
+/**
+ * @brief       Unmaps a file previously mapped with fmap(...).
+ *
+ * @param       data A pointer to the first byte of the mapped file.
+ * @param       size The size of the mapped file, as returned by fmap(...).
+ * @return      TRUE in case of success, else FALSE.
+ */
+CALC_EXTERN bool_t CALC_STDCALL funmap(byte_t *const data, size_t size);
+
+CALC_C_HEADER_END
+
+#endif /* CALC_BASE_FMAP_H_ */
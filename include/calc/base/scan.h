@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * @file        scan.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc programming language project,
+ *              under the Apache License v2.0. See LICENSE file for license
+ *              informations.
+ *
+ * @version     1.1
+ *
+ * @brief       In this header are defined functions to classify and scan
+ *              buffers of bytes in blocks, using SIMD instructions when
+ *              they're available.
+ */
+
+#ifndef CALC_BASE_SCAN_H_
+#define CALC_BASE_SCAN_H_
+
+#include "calc/base/bool.h"
+#include "calc/base/byte.h"
+
+CALC_C_HEADER_BEGIN
+
+/**
+ * @brief       Computes the length of the run of ASCII bytes at the beginning
+ *              of a buffer, classifying 32 (AVX2) or 16 (SSE2) bytes at once.
+ *
+ * @param       buf The buffer to scan.
+ * @param       count The number of bytes in the buffer.
+ * @return      The number of leading ASCII bytes, count if the whole buffer is
+ *              made of ASCII bytes.
+ */
+CALC_EXTERN size_t CALC_STDCALL bufascii(const byte_t *const buf, size_t count);
+
+/**
+ * @brief       Counts the occurrences of a byte in a buffer, comparing 32
+ *              (AVX2) or 16 (SSE2) bytes at once.
+ *
+ * @param       buf The buffer to scan.
+ * @param       count The number of bytes in the buffer.
+ * @param       value The byte to count.
+ * @return      The number of bytes equal to value.
+ */
+CALC_EXTERN size_t CALC_STDCALL bufcount(const byte_t *const buf, size_t count, byte_t value);
+
+/**
+ * @brief       Counts the UTF-8 characters in a buffer, as the bytes that are
+ *              not continuation bytes (0x80-0xBF), comparing 32 (AVX2) or 16
+ *              (SSE2) bytes at once.
+ *
+ * @param       buf The buffer to scan.
+ * @param       count The number of bytes in the buffer.
+ * @return      The number of characters beginning in the buffer.
+ */
+CALC_EXTERN size_t CALC_STDCALL bufchars(const byte_t *const buf, size_t count);
+
+/**
+ * @brief       Computes the length of the run of blanks (spaces, tabs, EOLs,
+ *              vertical tabs, form feeds and carriage returns) at the
+ *              beginning of a buffer, classifying 32 (AVX2) or 16 (SSE2)
+ *              bytes at once.
+ *
+ * @param       buf The buffer to scan.
+ * @param       count The number of bytes in the buffer.
+ * @return      The number of leading blanks, count if the whole buffer is
+ *              made of blanks.
+ */
+CALC_EXTERN size_t CALC_STDCALL bufblanks(const byte_t *const buf, size_t count);
+
+/**
+ * @brief       Computes the length of the run of identifier bytes (letters,
+ *              digits, underscores and non-ASCII bytes) at the beginning of a
+ *              buffer, classifying 32 (AVX2) or 16 (SSE2) bytes at once.
+ *
+ * @param       buf The buffer to scan.
+ * @param       count The number of bytes in the buffer.
+ * @return      The number of leading identifier bytes, count if the whole
+ *              buffer is made of them.
+ */
+CALC_EXTERN size_t CALC_STDCALL bufident(const byte_t *const buf, size_t count);
+
+/**
+ * @brief       Computes the length of the run of bytes before the first
+ *              occurrence of a byte in a buffer, comparing 32 (AVX2) or 16
+ *              (SSE2) bytes at once.
+ *
+ * @param       buf The buffer to scan.
+ * @param       count The number of bytes in the buffer.
+ * @param       value The byte to look for.
+ * @return      The index of the first byte equal to value, count if there's
+ *              none.
+ */
+CALC_EXTERN size_t CALC_STDCALL bufuntil(const byte_t *const buf, size_t count, byte_t value);
+
+CALC_C_HEADER_END
+
+#endif /* CALC_BASE_SCAN_H_ */
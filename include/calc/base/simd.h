@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file        simd.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc programming language project,
+ *              under the Apache License v2.0. See LICENSE file for license
+ *              informations.
+ *
+ * @version     1.1
+ *
+ * @brief       In this header are defined constants to check which SIMD
+ *              instruction sets are available at compile time, and helper
+ *              functions to deal with SIMD masks.
+ */
+
+#ifndef CALC_BASE_SIMD_H_
+#define CALC_BASE_SIMD_H_
+
+#include "calc/base/defs.h"
+
+#ifndef CALC_SIMD_SSE2
+#   if defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && (_M_IX86_FP >= 2))
+/**
+ * @brief       This constant can be used to check if SSE2 instructions are
+ *              available.
+ */
+#       define CALC_SIMD_SSE2 1
+#   else
+/**
+ * @brief       This constant can be used to check if SSE2 instructions are
+ *              available.
+ */
+#       define CALC_SIMD_SSE2 0
+#   endif
+#endif
+
+#ifndef CALC_SIMD_AVX2
+#   if defined __AVX2__
+/**
+ * @brief       This constant can be used to check if AVX2 instructions are
+ *              available. (enabled by CALC_ENABLE_AVX2 option)
+ */
+#       define CALC_SIMD_AVX2 1
+#   else
+/**
+ * @brief       This constant can be used to check if AVX2 instructions are
+ *              available. (enabled by CALC_ENABLE_AVX2 option)
+ */
+#       define CALC_SIMD_AVX2 0
+#   endif
+#endif
+
+#if CALC_SIMD_AVX2
+#   include <immintrin.h>
+#elif CALC_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+#if CALC_COMPILER_ID == CALC_COMPILER_ID_MSVC
+#   include <intrin.h>
+#endif
+
+CALC_C_HEADER_BEGIN
+
+/**
+ * @brief       Counts the trailing zero bits of a non-zero mask, that is the
+ *              index of its first set bit.
+ *
+ * @param       mask The mask to scan, it must not be 0.
+ * @return      The number of trailing zero bits.
+ */
+CALC_INLINE unsigned int CALC_STDCALL simdctz(unsigned int mask)
+{
+#if CALC_COMPILER_ID == CALC_COMPILER_ID_MSVC
+    unsigned long index;
+
+    _BitScanForward(&index, (unsigned long)mask);
+
+    return (unsigned int)index;
+#elif (CALC_COMPILER_ID == CALC_COMPILER_ID_GNUC) || (CALC_COMPILER_ID == CALC_COMPILER_ID_LLVM)
+    return (unsigned int)__builtin_ctz(mask);
+#else
+    unsigned int index = 0;
+
+    while (!(mask & 1))
+        mask >>= 1, index++;
+
+    return index;
+#endif
+}
+
+/**
+ * @brief       Counts the set bits of a mask.
+ *
+ * @param       mask The mask to count.
+ * @return      The number of set bits.
+ */
+CALC_INLINE unsigned int CALC_STDCALL simdpopcnt(unsigned int mask)
+{
+#if CALC_COMPILER_ID == CALC_COMPILER_ID_MSVC
+    return (unsigned int)__popcnt(mask);
+#elif (CALC_COMPILER_ID == CALC_COMPILER_ID_GNUC) || (CALC_COMPILER_ID == CALC_COMPILER_ID_LLVM)
+    return (unsigned int)__builtin_popcount(mask);
+#else
+    unsigned int count = 0;
+
+    for (; mask; mask &= mask - 1)
+        count++;
+
+    return count;
+#endif
+}
+
+CALC_C_HEADER_END
+
+#endif /* CALC_BASE_SIMD_H_ */
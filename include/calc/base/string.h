@@ -24,6 +24,10 @@
 
 #include <string.h>
 
+#if !CALC_PLATFORM_IS_WINDOWS
+#   include <strings.h>
+#endif
+
 CALC_C_HEADER_BEGIN
 
 #ifndef NUL
@@ -72,7 +76,7 @@ CALC_INLINE int CALC_STDCALL istermn(int c)
 
 // String manipulation functions
 
-#if CALC_PLATFORM_IS_MACOS
+#if !CALC_PLATFORM_IS_WINDOWS
 /// @brief Performs a case-insensitive comparison of strings.
 #   define stricmp(str1, str2) strcasecmp((str1), (str2))
 #endif
@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * @file        thread.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc programming language project,
+ *              under the Apache License v2.0. See LICENSE file for license
+ *              informations.
+ *
+ * @version     1.1
+ *
+ * @brief       In this header are defined functions to spawn threads and
+ *              to synchronize them with mutexes and condition variables.
+ */
+
+#ifndef CALC_BASE_THREAD_H_
+#define CALC_BASE_THREAD_H_
+
+#include "calc/base/bool.h"
+#include "calc/base/dload.h"
+
+CALC_C_HEADER_BEGIN
+
+/**
+ * @brief       Thread routine datatype.
+ */
+typedef void (CALC_STDCALL *thrdfunc_t)(void *arg);
+
+/**
+ * @brief       Spawns a new thread that runs the specified routine.
+ *
+ * @param       func The routine to run.
+ * @param       arg The argument to pass to the routine.
+ * @return      An opaque handle to the new thread, or NULL in case of failure.
+ */
+CALC_EXTERN handle_t CALC_STDCALL thrdspawn(thrdfunc_t func, void *arg);
+
+/**
+ * @brief       Waits for the termination of a thread and releases its handle.
+ *
+ * @param       thread The handle of the thread to join.
+ * @return      TRUE in case of success, else FALSE.
+ */
+CALC_EXTERN bool_t CALC_STDCALL thrdjoin(handle_t thread);
+
+/**
+ * @brief       Gets the number of hardware threads available to the process.
+ *
+ * @return      The number of available hardware threads, at least 1.
+ */
+CALC_EXTERN unsigned int CALC_STDCALL thrdcount(void);
+
+/**
+ * @brief       Creates a new mutex.
+ *
+ * @return      An opaque handle to the new mutex.
+ */
+CALC_EXTERN handle_t CALC_STDCALL mtxcreate(void);
+
+/**
+ * @brief       Locks a mutex, waiting until it's available.
+ *
+ * @param       mutex The handle of the mutex to lock.
+ */
+CALC_EXTERN void CALC_STDCALL mtxlock(handle_t mutex);
+
+/**
+ * @brief       Unlocks a mutex.
+ *
+ * @param       mutex The handle of the mutex to unlock.
+ */
+CALC_EXTERN void CALC_STDCALL mtxunlock(handle_t mutex);
+
+/**
+ * @brief       Deletes a mutex releasing its handle.
+ *
+ * @param       mutex The handle of the mutex to delete.
+ */
+CALC_EXTERN void CALC_STDCALL mtxdelete(handle_t mutex);
+
+/**
+ * @brief       Creates a new condition variable.
+ *
+ * @return      An opaque handle to the new condition variable.
+ */
+CALC_EXTERN handle_t CALC_STDCALL cndcreate(void);
+
+/**
+ * @brief       Atomically unlocks the mutex and waits for the condition
+ *              variable to be signaled, then locks again the mutex.
+ *
+ * @param       cond The handle of the condition variable to wait for.
+ * @param       mutex The handle of the locked mutex.
+ */
+CALC_EXTERN void CALC_STDCALL cndwait(handle_t cond, handle_t mutex);
+
+/**
+ * @brief       Wakes up one of the threads waiting for a condition variable.
+ *
+ * @param       cond The handle of the condition variable to signal.
+ */
+CALC_EXTERN void CALC_STDCALL cndsignal(handle_t cond);
+
+/**
+ * @brief       Wakes up all the threads waiting for a condition variable.
+ *
+ * @param       cond The handle of the condition variable to broadcast.
+ */
+CALC_EXTERN void CALC_STDCALL cndbroadcast(handle_t cond);
+
+/**
+ * @brief       Deletes a condition variable releasing its handle.
+ *
+ * @param       cond The handle of the condition variable to delete.
+ */
+CALC_EXTERN void CALC_STDCALL cnddelete(handle_t cond);
+
+CALC_C_HEADER_END
+
+#endif /* CALC_BASE_THREAD_H_ */
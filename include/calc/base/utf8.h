@@ -300,6 +300,51 @@ CALC_EXTERN const char *CALC_STDCALL utf8_errmsg(ssize_t errcode);
 ///
 CALC_EXTERN ssize_t CALC_STDCALL utf8_iterate(const uint8_t *str, ssize_t strlen, int32_t *codepoint_ref);
 
+/// @brief Checks that the first `strlen` bytes of `str` are a well-formed UTF-8
+///        string: no stray continuation bytes, truncated, overlong or
+///        surrogate sequences, nor codepoints above U+10FFFF. Only the runs
+///        of ASCII bytes are skipped in blocks, by the SIMD kernels of
+///        bufascii(): multi-byte sequences are checked one at a time, by the
+///        scalar rules of utf8_iterate().
+///
+///        The offset of the first byte of the first invalid sequence is
+///        returned, or `strlen` if the whole string is valid.
+///
+CALC_EXTERN size_t CALC_STDCALL utf8_validate(const uint8_t *str, size_t strlen);
+
+/// @brief Reads a single codepoint from the UTF-8 sequence being pointed to by
+///        `str`, like utf8_iterate() does, but without checking it: the
+///        sequence must be valid (e.g. checked by utf8_validate()).
+///
+///        The codepoint is stored in the variable pointed to by
+///        `codepoint_ref` and the number of bytes read is returned.
+///
+CALC_INLINE ssize_t CALC_STDCALL utf8_decode(const uint8_t *str, int32_t *codepoint_ref)
+{
+    static const uint8_t masks[5] = {0x00, 0x7F, 0x1F, 0x0F, 0x07};
+
+    ssize_t length = utf8_utf8class[*str];
+    int32_t uc = *str & masks[length];
+
+    switch (length)
+    {
+    case 4:
+        uc = (uc << 6) | (*++str & 0x3F);
+        // fallthrough
+    case 3:
+        uc = (uc << 6) | (*++str & 0x3F);
+        // fallthrough
+    case 2:
+        uc = (uc << 6) | (*++str & 0x3F);
+    default:
+        break;
+    }
+
+    *codepoint_ref = uc;
+
+    return length;
+}
+
 /// @brief Check if a codepoint is valid (regardless of whether it has been
 ///        assigned a value by the current Unicode standard).
 /// @return 1 if the given `codepoint` is valid and otherwise return 0.
@@ -315,6 +360,24 @@ CALC_EXTERN bool_t CALC_STDCALL utf8_codepoint_valid(int32_t codepoint);
 ///
 CALC_EXTERN ssize_t CALC_STDCALL utf8_encode_char(int32_t codepoint, uint8_t *dst);
 
+/// @brief Transcodes `count` bytes of Latin-1 (ISO-8859-1) text into UTF-8,
+///        copying the runs of ASCII bytes in blocks. The byte array pointed
+///        to by `dst` must be at least `2 * count` bytes long.
+///
+///        The number of bytes written is returned.
+///
+CALC_EXTERN size_t CALC_STDCALL utf8_from_latin1(const uint8_t *src, size_t count, uint8_t *dst);
+
+/// @brief Transcodes `count` bytes of UTF-16LE text into UTF-8, converting
+///        8 ASCII code units at once when SSE2 is available. Unpaired
+///        surrogates and a trailing odd byte are replaced by U+FFFD. The byte
+///        array pointed to by `dst` must be at least `3 * (count / 2) + 3`
+///        bytes long.
+///
+///        The number of bytes written is returned.
+///
+CALC_EXTERN size_t CALC_STDCALL utf8_from_utf16le(const uint8_t *src, size_t count, uint8_t *dst);
+
 /// @brief Look up the properties for a given codepoint.
 ///
 /// @param codepoint The Unicode codepoint.
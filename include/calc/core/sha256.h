@@ -72,6 +72,8 @@ CALC_API CalcSha256Context_t *CALC_STDCALL calcCreateSha256Context(void);
 /// @param data A pointer to the buffer to use to fill
 ///             the context's data.
 /// @param count The number of bytes in data buffer.
+/// @param key The input key, when it's NULL the standard SHA-256 round
+///            constants are used.
 /// @return ctx parameter.
 CALC_API CalcSha256Context_t *CALC_STDCALL calcSha256Update(CalcSha256Context_t *const ctx, const byte_t *const data, size_t count, const CalcSha256HashKey_t key);
 /// @brief Computes the hash code block.
@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file        lexer.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to scan
+ *              the tokens of a source stream.
+ */
+
+#ifndef CALC_LEX_LEXER_H_
+#define CALC_LEX_LEXER_H_
+
+#include "calc/lex/tokens.h"
+#include "calc/source/source_stream.h"
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Token data structure, a token scanned by the lexer.
+typedef struct _CalcToken
+{
+    /// @brief The code of the token.
+    CalcTokenCode_t      code;
+    /// @brief The lexeme of the token, it points into the buffer of the source
+    ///        stream and it's valid until the next token is scanned.
+    CalcSourceSpan_t     lexeme;
+    /// @brief The compact location of the beginning of the token, that is the
+    ///        base of the stream plus the byte offset of the token. The line
+    ///        and the column are decoded on demand, by the source manager of
+    ///        the stream or by calcSourceStreamResolveLocation.
+    CalcSourceLoc_t      loc;
+} CalcToken_t;
+
+/// @brief Lexer data structure. The lexer is a DFA whose tables are generated
+///        at build time from tokens.inc: bytes are mapped to classes of bytes
+///        that are never distinguished, so each byte costs one lookup of the
+///        next state. The longest lexeme is matched, and among the tokens with
+///        the same lexeme directives, punctuators, literals and identifiers
+///        are chosen in this order. Keywords are scanned as identifiers and
+///        found in the perfect hash of calcGetKeywordToken (contextual ones
+///        are scanned as CALC_TOKEN_IDENT_OR_KWORD). Blanks and comments are
+///        skipped.
+typedef struct _CalcLexer
+{
+    /// @brief A pointer to the source stream from which the tokens are
+    ///        scanned, it's not deleted with the lexer.
+    CalcSourceStream_t *sourceStream;
+    /// @brief The bytes peeked from the stream, they're scanned by many
+    ///        tokens until the stream is refilled or moved out of them.
+    CalcSourceSpan_t    window;
+    /// @brief The position in the stream of the first byte of the window.
+    uint64_t            windowPosition;
+    /// @brief The end of the buffer of the stream when the window was peeked,
+    ///        the window is valid until it changes.
+    uint64_t            windowEnd;
+} CalcLexer_t;
+
+/// @brief Creates a new lexer that scans the tokens of a source stream.
+/// @param sourceStream A pointer to the source stream to scan.
+/// @return A pointer to the new lexer.
+CALC_API CalcLexer_t *CALC_STDCALL calcCreateLexer(CalcSourceStream_t *const sourceStream);
+
+/// @brief Scans the next token of the source stream of a lexer. Sequences of
+///        bytes that don't begin any token, unterminated literals and names of
+///        unknown directives are scanned as CALC_TOKEN_INVALID tokens. At the
+///        end of the stream CALC_TOKEN_TRIVIAL_ENDOF tokens are scanned.
+/// @param lexer A pointer to the lexer.
+/// @param outToken A pointer to the token in which store the scanned token, it
+///                 can be NULL.
+/// @return The code of the scanned token.
+CALC_API CalcTokenCode_t CALC_STDCALL calcLexerNextToken(CalcLexer_t *const lexer, CalcToken_t *const outToken);
+
+/// @brief Matches the token at the beginning of a sequence of bytes, as the
+///        lexer does after the blanks: the longest lexeme is matched, or a
+///        CALC_TOKEN_INVALID token if none can be matched. It doesn't skip
+///        comments, they're matched as CALC_TOKEN_TRIVIAL_REMLN tokens.
+/// @param data A pointer to the bytes, the first one must not be a blank.
+/// @param length The number of bytes, it must not be 0.
+/// @param outLength A pointer to the variable in which store the length of
+///                  the lexeme.
+/// @return The code of the matched token.
+CALC_API CalcTokenCode_t CALC_STDCALL calcLexerMatch(const byte_t *const data, size_t length, size_t *const outLength);
+
+/// @brief Deletes a lexer, its source stream is not deleted.
+/// @param lexer A pointer to the lexer to delete.
+CALC_API void CALC_STDCALL calcDeleteLexer(CalcLexer_t *const lexer);
+
+CALC_C_HEADER_END
+
+#endif // CALC_LEX_LEXER_H_
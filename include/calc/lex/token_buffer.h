@@ -0,0 +1,129 @@
+#pragma once
+
+/**
+ * @file        token_buffer.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to store
+ *              the tokens scanned from a source buffer.
+ */
+
+#ifndef CALC_LEX_TOKEN_BUFFER_H_
+#define CALC_LEX_TOKEN_BUFFER_H_
+
+#include "calc/lex/lexer.h"
+
+#ifndef CALC_TOKEN_BUFFER_CAPACITY
+/// @brief This constant macro represents the default number of tokens that
+///        a token buffer can store before it grows.
+#   define CALC_TOKEN_BUFFER_CAPACITY 1024
+#endif // CALC_TOKEN_BUFFER_CAPACITY
+
+#ifndef CALC_TOKEN_BUFFER_CHUNK_SIZE
+/// @brief This constant macro represents the default minimum number of bytes
+///        of the chunks in which sources are split by parallel scans.
+#   define CALC_TOKEN_BUFFER_CHUNK_SIZE (1024 * 1024)
+#endif // CALC_TOKEN_BUFFER_CHUNK_SIZE
+
+#ifndef CALC_TOKEN_BUFFER_MAX_OFFSET
+/// @brief This constant macro represents the maximum offset (and the maximum
+///        end of a lexeme) that a token buffer can store: sources past it
+///        can't be scanned.
+#   define CALC_TOKEN_BUFFER_MAX_OFFSET UINT32_MAX
+#endif // CALC_TOKEN_BUFFER_MAX_OFFSET
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Token buffer data structure. Tokens are stored as a structure of
+///        arrays in a single block, that grows doubling its capacity: the
+///        codes, the offsets and the lengths of the lexemes. Lexemes are not
+///        copied, they're referenced by their offset in the source buffer.
+///        Parsers walk the codes array and look at the lexemes only when
+///        they need them.
+typedef struct _CalcTokenBuffer
+{
+    /// @brief A pointer to the source buffer from which the tokens are
+    ///        scanned, it's not deleted with the token buffer.
+    const CalcSourceBuffer_t *sourceBuffer;
+    /// @brief The codes of the tokens, it's the beginning of the block.
+    CalcTokenCode_t          *codes;
+    /// @brief The offsets of the lexemes in the source buffer.
+    uint32_t                 *offsets;
+    /// @brief The lengths (in bytes) of the lexemes.
+    uint32_t                 *lengths;
+    /// @brief The number of stored tokens.
+    size_t                    count;
+    /// @brief The number of tokens that can be stored before growing.
+    size_t                    capacity;
+} CalcTokenBuffer_t;
+
+/// @brief Creates a new empty token buffer for the tokens of a source buffer.
+/// @param sourceBuffer A pointer to the source buffer referenced by the
+///                     lexemes, it must store the whole source (not the ring
+///                     of an open source stream).
+/// @param capacity The initial number of tokens that can be stored, if it's 0
+///                 CALC_TOKEN_BUFFER_CAPACITY is used.
+/// @return A pointer to the new token buffer.
+CALC_API CalcTokenBuffer_t *CALC_STDCALL calcCreateTokenBuffer(const CalcSourceBuffer_t *const sourceBuffer, size_t capacity);
+
+/// @brief Appends a token to a token buffer, growing it when it's full.
+/// @param tokenBuffer A pointer to the token buffer.
+/// @param code The code of the token.
+/// @param offset The offset of the lexeme in the source buffer.
+/// @param length The length (in bytes) of the lexeme.
+CALC_API void CALC_STDCALL calcTokenBufferPush(CalcTokenBuffer_t *const tokenBuffer, CalcTokenCode_t code, uint32_t offset, uint32_t length);
+
+/// @brief Scans all the tokens of a lexer into a token buffer, up to the
+///        CALC_TOKEN_TRIVIAL_ENDOF token that is stored too. The source stream
+///        of the lexer must read the source buffer of the token buffer.
+/// @param tokenBuffer A pointer to the token buffer.
+/// @param lexer A pointer to the lexer from which scan the tokens.
+/// @return The number of scanned tokens, or 0 if the source stream doesn't
+///         read the source buffer or a lexeme is out of the 32-bit offsets.
+CALC_API size_t CALC_STDCALL calcTokenBufferScan(CalcTokenBuffer_t *const tokenBuffer, CalcLexer_t *const lexer);
+
+/// @brief Scans all the tokens of the source buffer of a token buffer on a
+///        pool of threads, storing the same tokens that calcTokenBufferScan
+///        stores. The source is split in chunks that end at EOLs and each
+///        chunk is lexed concurrently under the two states in which a line
+///        can begin: out of tokens or inside a block comment (the only tokens
+///        that can span lines). Then a sequential pass chooses the state of
+///        each chunk from the end of the previous one and concatenates their
+///        tokens.
+/// @param tokenBuffer A pointer to the token buffer.
+/// @param chunkSize The minimum number of bytes of each chunk, 0 to use the
+///                  default one (see CALC_TOKEN_BUFFER_CHUNK_SIZE).
+/// @param threadCount The maximum number of lexing threads, 0 to use one for
+///                    each hardware thread.
+/// @return The number of scanned tokens, or 0 if a lexeme is out of the 32-bit
+///         offsets.
+CALC_API size_t CALC_STDCALL calcTokenBufferScanParallel(CalcTokenBuffer_t *const tokenBuffer, size_t chunkSize, size_t threadCount);
+
+/// @brief Gets the lexeme of a token stored in a token buffer.
+/// @param tokenBuffer A pointer to the token buffer.
+/// @param index The index of the token.
+/// @param outLexeme A pointer to the span in which store the lexeme.
+CALC_INLINE void CALC_STDCALL calcTokenBufferGetLexeme(const CalcTokenBuffer_t *const tokenBuffer, size_t index, CalcSourceSpan_t *const outLexeme)
+{
+    outLexeme->data = tokenBuffer->sourceBuffer->data + tokenBuffer->offsets[index];
+    outLexeme->length = (size_t)tokenBuffer->lengths[index];
+}
+
+/// @brief Removes all the tokens from a token buffer, keeping its block.
+/// @param tokenBuffer A pointer to the token buffer to clear.
+CALC_API void CALC_STDCALL calcClearTokenBuffer(CalcTokenBuffer_t *const tokenBuffer);
+
+/// @brief Deletes a token buffer, its source buffer is not deleted.
+/// @param tokenBuffer A pointer to the token buffer to delete.
+CALC_API void CALC_STDCALL calcDeleteTokenBuffer(CalcTokenBuffer_t *const tokenBuffer);
+
+CALC_C_HEADER_END
+
+#endif // CALC_LEX_TOKEN_BUFFER_H_
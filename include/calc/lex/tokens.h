@@ -57,6 +57,17 @@ typedef enum _CalcTokenCode
 ///         associated to the specified token.
 CALC_API const char *CALC_STDCALL calcGetTokenLexeme(CalcTokenCode_t token);
 
+/// @brief Looks up the keyword with the specified lexeme, through a perfect
+///        hash generated from tokens.inc: the slot is computed from the length
+///        and the first and last characters, then a single comparison checks
+///        the lexeme. It also recognizes contextual keywords, that are scanned
+///        as CALC_TOKEN_IDENT_OR_KWORD.
+/// @param data A pointer to the characters of the lexeme.
+/// @param length The number of characters of the lexeme.
+/// @return The code of the keyword, or CALC_TOKEN_INVALID if the lexeme is
+///         not a keyword.
+CALC_API CalcTokenCode_t CALC_STDCALL calcGetKeywordToken(const char *const data, size_t length);
+
 CALC_C_HEADER_END
 
 #endif // CALC_LEX_TOKENS_H_
@@ -23,15 +23,28 @@
 #include "calc/base/byte.h"
 #include "calc/base/file.h"
 
+#ifndef CALC_SOURCE_INVALID_CHAR
+/// @brief This constant macro represents the character returned in place of
+///        an invalid sequence of bytes (U+FFFD replacement character). Each
+///        invalid sequence is one byte wide.
+#   define CALC_SOURCE_INVALID_CHAR 0xFFFD
+#endif // CALC_SOURCE_INVALID_CHAR
+
 CALC_C_HEADER_BEGIN
 
-/// @brief Enumeration of supported encodings.
+/// @brief Enumeration of supported encodings. Source buffers always store
+///        their content as UTF-8 (or ASCII): the other encodings are
+///        transcoded when the buffer is created.
 typedef enum _CalcSourceEncoding
 {
     /// @brief ASCII encoding.
-    CALC_SOURCE_ENCODING_ASCII = 0x10,
+    CALC_SOURCE_ENCODING_ASCII    = 0x10,
     /// @brief UTF-8 encoding.
-    CALC_SOURCE_ENCODING_UTF_8 = 0x20,
+    CALC_SOURCE_ENCODING_UTF_8    = 0x20,
+    /// @brief Latin-1 (ISO-8859-1) encoding.
+    CALC_SOURCE_ENCODING_LATIN_1  = 0x30,
+    /// @brief UTF-16 little-endian encoding.
+    CALC_SOURCE_ENCODING_UTF_16LE = 0x40,
 } CalcSourceEncoding_t;
 
 /// @brief Source buffer data structure.
@@ -42,6 +55,28 @@ typedef struct _CalcSourceBuffer
     /// @brief The maximum number of characters that this source buffer can
     ///        contain.
     size_t  size;
+    /// @brief The number of bytes allocated for the buffer's data, it can be
+    ///        greater than size (0 when the data is mapped).
+    size_t  capacity;
+    /// @brief When it's set to TRUE the buffer's data is a read-only memory
+    ///        mapping of a file, followed by a NUL byte, that is released on
+    ///        buffer deletion.
+    bool_t  isMapped;
+    /// @brief When it's set to TRUE the buffer's content has been validated
+    ///        as a well-formed UTF-8 string, so its characters can be decoded
+    ///        without any check. Mappings are validated on demand, by
+    ///        calcValidateSourceBuffer.
+    bool_t  isValidated;
+    /// @brief The offset of the first byte of the first invalid UTF-8
+    ///        sequence found validating the buffer's content, or the length of
+    ///        the content if it's valid.
+    size_t  invalidOffset;
+    /// @brief A pointer to the lines index of the buffer's content, or NULL
+    ///        until it's requested by calcGetSourceLines.
+    struct _CalcSourceLines *lines;
+    /// @brief The encoding of the source from which the buffer was created,
+    ///        as declared or detected by its BOM.
+    CalcSourceEncoding_t encoding;
 } CalcSourceBuffer_t;
 
 /// @brief Creates a new source buffer of the same number of characters as
@@ -61,20 +96,70 @@ CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBuffer(size_t size, by
 /// @return A pointer to the new source buffer.
 CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromText(const char *const text);
 /// @brief Creates a new source buffers with the entire content of the file
-///        specified by the path parameter.
+///        specified by the path parameter. When it's possible the file is
+///        mapped in memory, otherwise its content is loaded in the buffer.
 /// @param path The path to the file to load and wrap into the buffer.
+/// @param encoding The encoding of the file, a BOM at its beginning takes
+///                 precedence. Latin-1 and UTF-16LE files are transcoded.
 /// @return A pointer to the new source buffer.
-CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromFile(const char *const path);
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromFile(const char *const path, CalcSourceEncoding_t encoding);
+/// @brief Creates a new source buffer that wraps a read-only memory mapping
+///        of the file specified by the path parameter, without copying its
+///        content. The mapping is followed by a NUL byte and it's released
+///        by calcDeleteSourceBuffer. Files that must be transcoded (or that
+///        begin with a BOM) are copied once, and the mapping is released.
+///        The other ones are not validated, so no page is read beyond the
+///        first one until the content is read or validated on demand.
+/// @param path The path to the file to map and wrap into the buffer.
+/// @param encoding The encoding of the file, a BOM at its beginning takes
+///                 precedence.
+/// @return A pointer to the new source buffer, or NULL when the file cannot
+///         be mapped.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromMappedFile(const char *const path, CalcSourceEncoding_t encoding);
+/// @brief Creates a new source buffer reading eagerly the whole content of the
+///        file specified by the path parameter (see fload), so that no I/O is
+///        left for the first reads of the buffer.
+/// @param path The path to the file to load into the buffer.
+/// @param encoding The encoding of the file, a BOM at its beginning takes
+///                 precedence.
+/// @return A pointer to the new source buffer, or NULL when the file cannot
+///         be loaded.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromLoadedFile(const char *const path, CalcSourceEncoding_t encoding);
 
 /// @brief Creates a new source buffer loading the content of a file stream,
 ///        do not use this function to load a source buffer form stdin.
 /// @param stream A source file stream.
+/// @param encoding The encoding of the stream, a BOM at its beginning takes
+///                 precedence.
 /// @return A pointer to the new source buffer.
-CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromStream(FILE *const stream);
-/// @brief Creates a new source buffer loading the next line of the stdin.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromStream(FILE *const stream, CalcSourceEncoding_t encoding);
+/// @brief Creates a new source buffer loading the next line of the stdin, of
+///        any length, when it's a terminal. Otherwise (e.g. a pipe) the whole
+///        content of the stdin is loaded in blocks. The content is transcoded
+///        when it begins with an UTF-16LE BOM.
 /// @return A pointer to the new source buffer.
 CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromStdin(void);
 
+/// @brief Transcodes the content of a source buffer into UTF-8, replacing it.
+///        The encoding is detected by the BOM at the beginning of the content
+///        (that is removed), otherwise the specified one is used. The content
+///        is then validated. Buffers created from files and streams are
+///        transcoded on their creation, so this function must not be called
+///        on them again.
+/// @param sourceBuffer A pointer to the source buffer to transcode.
+/// @param encoding The encoding of the content when it has no BOM.
+/// @return TRUE if the transcoded content is a well-formed UTF-8 string, else
+///         FALSE.
+CALC_API bool_t CALC_STDCALL calcTranscodeSourceBuffer(CalcSourceBuffer_t *const sourceBuffer, CalcSourceEncoding_t encoding);
+
+/// @brief Validates the content of a source buffer (NUL sentinel excluded) as
+///        an UTF-8 string, updating its isValidated and invalidOffset fields.
+///        Buffers created from text, files and streams are validated on their
+///        creation, except for the mapped ones.
+/// @param sourceBuffer A pointer to the source buffer to validate.
+/// @return TRUE if the content is a well-formed UTF-8 string, else FALSE.
+CALC_API bool_t CALC_STDCALL calcValidateSourceBuffer(CalcSourceBuffer_t *const sourceBuffer);
+
 /// @brief Gets thecharacter in the position specified by position parameter.
 /// @param sourceBuffer A pointer to the source buffer from which read.
 /// @param encoding The encoding of the character to read.
@@ -92,7 +177,8 @@ CALC_API int CALC_STDCALL calcDumpSourceBuffer(const CalcSourceBuffer_t *const s
 
 /// @brief Clears the content of the source buffer.
 /// @param sourceBuffer A pointer to the source buffer to clear.
-/// @return TRUE when the buffer is cleared succefully, FALSE in the other cases.
+/// @return TRUE when the buffer is cleared succefully, FALSE in the other cases
+///         (mapped buffers are read-only and can't be cleared).
 CALC_API bool_t CALC_STDCALL calcClearSourceBuffer(CalcSourceBuffer_t *const sourceBuffer);
 
 /// @brief Deletes the specified source buffer releasing each used resource.
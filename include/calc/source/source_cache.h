@@ -0,0 +1,156 @@
+#pragma once
+
+/**
+ * @file        source_cache.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to cache
+ *              the artifacts produced from source files, keyed by the SHA-256
+ *              fingerprints of their contents.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_CACHE_H_
+#define CALC_SOURCE_SOURCE_CACHE_H_
+
+#include "calc/core/sha256.h"
+#include "calc/source/source_buffer.h"
+
+#ifndef CALC_SOURCE_CACHE_BUCKETS
+/// @brief This constant macro represents the number of buckets of the tables
+///        of the entries and of the artifacts of a source cache.
+#   define CALC_SOURCE_CACHE_BUCKETS 256
+#endif // CALC_SOURCE_CACHE_BUCKETS
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Source file status data structure, the identity of a source file
+///        and the metadata that change when it's modified.
+typedef struct _CalcSourceFileStatus
+{
+    /// @brief The identifier of the device on which the file is stored.
+    uint64_t device;
+    /// @brief The identifier of the file on its device.
+    uint64_t inode;
+    /// @brief The size (in bytes) of the file.
+    uint64_t size;
+    /// @brief The last modification time of the file (in nanoseconds when the
+    ///        platform supports it).
+    uint64_t mtime;
+} CalcSourceFileStatus_t;
+
+/// @brief Function that releases an artifact stored in a source cache.
+typedef void (CALC_STDCALL *CalcSourceArtifactDeleter_t)(void *artifact);
+
+/// @brief Source artifact data structure, the artifact produced from a
+///        content, shared by all the files with the same fingerprint.
+typedef struct _CalcSourceArtifact
+{
+    /// @brief The SHA-256 fingerprint of the content.
+    CalcSha256HashBlock_t          hash;
+    /// @brief The artifact produced from the content (e.g. a token stream or
+    ///        its diagnostics), or NULL.
+    void                          *data;
+    /// @brief The function that releases the artifact, it can be NULL.
+    CalcSourceArtifactDeleter_t    deleter;
+    /// @brief The number of entries with this content.
+    size_t                         references;
+    /// @brief The next artifact in the same bucket.
+    struct _CalcSourceArtifact    *next;
+} CalcSourceArtifact_t;
+
+/// @brief Source cache entry data structure, the status of a file got through
+///        its path, used to avoid reading it again.
+typedef struct _CalcSourceCacheEntry
+{
+    /// @brief The path to the source file.
+    char                          *path;
+    /// @brief The identifier of the device on which the file was stored.
+    uint64_t                       device;
+    /// @brief The identifier of the file on its device.
+    uint64_t                       inode;
+    /// @brief The size (in bytes) of the file.
+    uint64_t                       size;
+    /// @brief The last modification time of the file (in nanoseconds when the
+    ///        platform supports it).
+    uint64_t                       mtime;
+    /// @brief The SHA-256 fingerprint of the content of the file, as it's
+    ///        stored in the file (before any transcoding).
+    CalcSha256HashBlock_t          hash;
+    /// @brief A pointer to the artifact of the content of the file, in the
+    ///        table of the artifacts of the cache.
+    CalcSourceArtifact_t          *artifact;
+    /// @brief The next entry in the same bucket.
+    struct _CalcSourceCacheEntry  *next;
+} CalcSourceCacheEntry_t;
+
+/// @brief Source cache data structure, a table of artifacts keyed by the
+///        fingerprints of the contents. The table of entries keyed by path is
+///        only a fast path, to find the fingerprint of a file without reading
+///        it.
+typedef struct _CalcSourceCache
+{
+    /// @brief The buckets of the table of the entries.
+    CalcSourceCacheEntry_t *buckets[CALC_SOURCE_CACHE_BUCKETS];
+    /// @brief The buckets of the table of the artifacts.
+    CalcSourceArtifact_t   *artifacts[CALC_SOURCE_CACHE_BUCKETS];
+    /// @brief The number of entries in the table.
+    size_t                  count;
+    /// @brief The number of artifacts in the table.
+    size_t                  artifactCount;
+} CalcSourceCache_t;
+
+/// @brief Creates a new empty source cache.
+/// @return A pointer to the new source cache.
+CALC_API CalcSourceCache_t *CALC_STDCALL calcCreateSourceCache(void);
+
+/// @brief Gets the device, inode, size and modification time of a regular
+///        source file, without opening it.
+/// @param path The path to the source file.
+/// @param outStatus A pointer to the structure in which store the status.
+/// @return TRUE in case of success, FALSE if the file doesn't exist or it's
+///         not a regular file.
+CALC_API bool_t CALC_STDCALL calcGetSourceFileStatus(const char *const path, CalcSourceFileStatus_t *const outStatus);
+
+/// @brief Computes the SHA-256 fingerprint of the content of a source buffer
+///        (NUL sentinel excluded), in blocks.
+/// @param sourceBuffer A pointer to the source buffer.
+/// @param outHash The block in which write the fingerprint.
+CALC_API void CALC_STDCALL calcSourceBufferFingerprint(const CalcSourceBuffer_t *const sourceBuffer, byte_t *const outHash);
+
+/// @brief Looks up the entry of a source file. When the device, inode, size
+///        and modification time of the file are unchanged, the entry is
+///        returned without reading the file. Otherwise the file is loaded and
+///        fingerprinted in a single pass, and the entry points to the artifact
+///        of its fingerprint: files with the same content share it.
+/// @param sourceCache A pointer to the source cache.
+/// @param path The path to the source file.
+/// @param outBuffer A pointer to a variable in which store the loaded source
+///                  buffer, that belongs to the caller, or NULL when the file
+///                  was not read. The file is loaded and not mapped, so the
+///                  buffer is not affected by later changes. It can be NULL.
+/// @return A pointer to the entry of the file, or NULL if the file cannot be
+///         read.
+CALC_API CalcSourceCacheEntry_t *CALC_STDCALL calcSourceCacheLookup(CalcSourceCache_t *const sourceCache, const char *const path, CalcSourceBuffer_t **const outBuffer);
+
+/// @brief Stores the artifact of the content of an entry of a source cache,
+///        releasing the previous one. It's shared by all the entries with the
+///        same fingerprint.
+/// @param sourceCacheEntry A pointer to the entry.
+/// @param artifact The artifact to store, it can be NULL.
+/// @param deleter The function that releases the artifact, it can be NULL.
+CALC_API void CALC_STDCALL calcSourceCacheSetArtifact(CalcSourceCacheEntry_t *const sourceCacheEntry, void *const artifact, CalcSourceArtifactDeleter_t deleter);
+
+/// @brief Deletes a source cache, releasing all its entries and artifacts.
+/// @param sourceCache A pointer to the source cache to delete.
+CALC_API void CALC_STDCALL calcDeleteSourceCache(CalcSourceCache_t *const sourceCache);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_CACHE_H_
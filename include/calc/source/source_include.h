@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * @file        source_include.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to resolve
+ *              the files named by include directives and to load each of them
+ *              once per process, through a source cache.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_INCLUDE_H_
+#define CALC_SOURCE_SOURCE_INCLUDE_H_
+
+#include "calc/source/source_buffer.h"
+#include "calc/source/source_cache.h"
+
+#ifndef CALC_SOURCE_INCLUDE_CACHE_BUCKETS
+/// @brief This constant macro represents the number of buckets of the table
+///        of the resolutions of an include cache.
+#   define CALC_SOURCE_INCLUDE_CACHE_BUCKETS 256
+#endif // CALC_SOURCE_INCLUDE_CACHE_BUCKETS
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Function that checks if a macro is defined, used to know if the
+///        guard of an included file is still defined.
+typedef bool_t (CALC_STDCALL *CalcSourceMacroPredicate_t)(void *context, const char *name);
+
+/// @brief Source include data structure, a content of a file loaded by an
+///        include cache. A file reached through different paths (links or
+///        spellings of its path) has a single include. When the content of
+///        the file changes a new include is loaded, while the superseded one
+///        and its buffer stay alive until the cache is deleted, as tokens may
+///        still point into them.
+typedef struct _CalcSourceInclude
+{
+    /// @brief The path to the file, as it was first resolved.
+    char                        *path;
+    /// @brief A pointer to the source buffer that stores the content of the
+    ///        file, owned by the cache.
+    CalcSourceBuffer_t          *buffer;
+    /// @brief The SHA-256 fingerprint of the content of the file.
+    CalcSha256HashBlock_t        hash;
+    /// @brief When it's set to TRUE the file begins with '#pragma once'.
+    bool_t                       isOnce;
+    /// @brief The name of the macro of the include guard that wraps the whole
+    ///        file ('#ifndef NAME', '#define NAME', ..., '#endif'), or NULL.
+    char                        *guard;
+    /// @brief The number of the last translation unit that entered the file.
+    uint64_t                     unit;
+    /// @brief The include loaded before it by the same cache.
+    struct _CalcSourceInclude   *next;
+} CalcSourceInclude_t;
+
+/// @brief Source identity data structure, the current include of a file
+///        identified by its device and inode.
+typedef struct _CalcSourceIdentity
+{
+    /// @brief The identifier of the device on which the file is stored.
+    uint64_t                     device;
+    /// @brief The identifier of the file on its device.
+    uint64_t                     inode;
+    /// @brief A pointer to the current include of the file.
+    CalcSourceInclude_t         *include;
+    /// @brief The next identity in the same bucket.
+    struct _CalcSourceIdentity  *next;
+} CalcSourceIdentity_t;
+
+/// @brief Source resolution data structure, the file to which a name was
+///        resolved from a directory.
+typedef struct _CalcSourceResolution
+{
+    /// @brief The directory of the including file ("" for none).
+    char                          *directory;
+    /// @brief The name of the included file.
+    char                          *name;
+    /// @brief A pointer to the resolved include.
+    CalcSourceInclude_t           *include;
+    /// @brief The next resolution in the same bucket.
+    struct _CalcSourceResolution  *next;
+} CalcSourceResolution_t;
+
+/// @brief Source include cache data structure. The names of the included
+///        files are resolved through the search paths once, then the files
+///        are looked up in a source cache by their resolved path: they're read
+///        again only when their identity, size or modification time change,
+///        and reloaded only when their fingerprint changes too. The includes
+///        are kept by the identity of their files, not by their paths.
+typedef struct _CalcSourceIncludeCache
+{
+    /// @brief The directories in which the included files are searched, in
+    ///        order, after the directory of the including file.
+    char                   **paths;
+    /// @brief The number of search paths.
+    size_t                   pathCount;
+    /// @brief The buckets of the table of the resolutions.
+    CalcSourceResolution_t  *resolutions[CALC_SOURCE_INCLUDE_CACHE_BUCKETS];
+    /// @brief The buckets of the table of the identities of the loaded files.
+    CalcSourceIdentity_t    *identities[CALC_SOURCE_INCLUDE_CACHE_BUCKETS];
+    /// @brief A pointer to the source cache of the loaded files.
+    CalcSourceCache_t       *cache;
+    /// @brief The list of all the loaded includes, superseded ones too.
+    CalcSourceInclude_t     *includes;
+    /// @brief The number of the current translation unit.
+    uint64_t                 unit;
+    /// @brief The number of includes loaded by the cache.
+    size_t                   loads;
+    /// @brief The number of file system probes done to resolve names.
+    size_t                   probes;
+} CalcSourceIncludeCache_t;
+
+/// @brief Creates a new include cache.
+/// @param searchPaths A list of directories separated by CALC_PATHSEP (like
+///                    the PATH environment variable), it can be NULL.
+/// @return A pointer to the new include cache.
+CALC_API CalcSourceIncludeCache_t *CALC_STDCALL calcCreateSourceIncludeCache(const char *const searchPaths);
+
+/// @brief Appends a directory to the search paths of an include cache.
+/// @param sourceIncludeCache A pointer to the include cache.
+/// @param directory The directory to append.
+CALC_API void CALC_STDCALL calcAddSourceIncludePath(CalcSourceIncludeCache_t *const sourceIncludeCache, const char *const directory);
+
+/// @brief Resolves the name of an included file, looking for it in the
+///        directory of the including file and then in the search paths, and
+///        gets its loaded content. Only the first resolution of a name from a
+///        directory probes the file system, later ones only check that the
+///        file is unchanged.
+/// @param sourceIncludeCache A pointer to the include cache.
+/// @param name The name of the included file, as written in the directive.
+/// @param includer The path to the including file, it can be NULL.
+/// @return A pointer to the include, whose buffer belongs to the cache, or
+///         NULL if the file cannot be found.
+CALC_API CalcSourceInclude_t *CALC_STDCALL calcSourceIncludeCacheResolve(CalcSourceIncludeCache_t *const sourceIncludeCache, const char *const name, const char *const includer);
+
+/// @brief Begins a new translation unit: files marked with '#pragma once' or
+///        wrapped by include guards can be entered again.
+/// @param sourceIncludeCache A pointer to the include cache.
+CALC_API void CALC_STDCALL calcSourceIncludeCacheBeginUnit(CalcSourceIncludeCache_t *const sourceIncludeCache);
+/// @brief Enters an included file in the current translation unit, telling
+///        if it must be lexed. Files marked with '#pragma once' are entered
+///        once per unit, guarded files are skipped while their guard macro is
+///        defined.
+/// @param sourceIncludeCache A pointer to the include cache.
+/// @param sourceInclude A pointer to the include.
+/// @param isDefined The function that checks if the guard is defined, when it's
+///                  NULL the guard is assumed to stay defined in the unit.
+/// @param context The context to pass to isDefined.
+/// @return TRUE if the file must be lexed, FALSE if it must be skipped.
+CALC_API bool_t CALC_STDCALL calcSourceIncludeCacheEnter(CalcSourceIncludeCache_t *const sourceIncludeCache, CalcSourceInclude_t *const sourceInclude, CalcSourceMacroPredicate_t isDefined, void *const context);
+
+/// @brief Deletes an include cache, releasing all its loaded includes.
+/// @param sourceIncludeCache A pointer to the include cache to delete.
+CALC_API void CALC_STDCALL calcDeleteSourceIncludeCache(CalcSourceIncludeCache_t *const sourceIncludeCache);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_INCLUDE_H_
@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * @file        source_lines.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to index
+ *              the lines of a source buffer and to map byte offsets to lines
+ *              and columns.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_LINES_H_
+#define CALC_SOURCE_SOURCE_LINES_H_
+
+#include "calc/source/source_buffer.h"
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Source lines index data structure. It stores the offsets at which
+///        each line of a source buffer begins, in ascending order.
+typedef struct _CalcSourceLines
+{
+    /// @brief The offsets of the first bytes of the lines, the first one is
+    ///        always 0.
+    size_t *starts;
+    /// @brief The number of lines.
+    size_t  count;
+    /// @brief The number of indexed bytes (NUL sentinel excluded).
+    size_t  length;
+} CalcSourceLines_t;
+
+/// @brief Source line data structure, it describes the line in which is
+///        located a byte offset.
+typedef struct _CalcSourceLine
+{
+    /// @brief A pointer to the first byte of the line, in the source buffer.
+    const byte_t *text;
+    /// @brief The number of bytes of the line, EOL excluded.
+    size_t        length;
+    /// @brief The number of the line (starting from 0).
+    uint64_t      ln;
+    /// @brief The number of the column (in bytes, starting from 0).
+    uint64_t      co;
+} CalcSourceLine_t;
+
+/// @brief Creates the lines index of the content of a source buffer, looking
+///        for EOL bytes with memchr.
+/// @param sourceBuffer A pointer to the source buffer to index.
+/// @return A pointer to the new lines index.
+CALC_API CalcSourceLines_t *CALC_STDCALL calcCreateSourceLines(const CalcSourceBuffer_t *const sourceBuffer);
+
+/// @brief Gets the lines index of a source buffer, creating it on the first
+///        call. The index is deleted with the buffer, or when the buffer is
+///        cleared.
+/// @param sourceBuffer A pointer to the source buffer, it must store its whole
+///                     content (not the ring of an open source stream).
+/// @return A pointer to the lines index of the buffer.
+CALC_API CalcSourceLines_t *CALC_STDCALL calcGetSourceLines(CalcSourceBuffer_t *const sourceBuffer);
+
+/// @brief Finds the line in which is located a byte offset, with a binary
+///        search on the lines index of a source buffer.
+/// @param sourceBuffer A pointer to the source buffer.
+/// @param offset The byte offset to map.
+/// @param outLine A pointer to the structure in which store the line, its
+///                number and the column of the offset.
+/// @return TRUE in case of success, FALSE if the offset is out of the content
+///         of the buffer.
+CALC_API bool_t CALC_STDCALL calcSourceBufferFindLine(CalcSourceBuffer_t *const sourceBuffer, size_t offset, CalcSourceLine_t *const outLine);
+
+/// @brief Deletes a lines index releasing each used resource.
+/// @param sourceLines A pointer to the lines index to delete.
+CALC_API void CALC_STDCALL calcDeleteSourceLines(CalcSourceLines_t *const sourceLines);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_LINES_H_
@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * @file        source_loader.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined functions to load many source files
+ *              at once, overlapping the latency of their I/O.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_LOADER_H_
+#define CALC_SOURCE_SOURCE_LOADER_H_
+
+#include "calc/source/source_buffer.h"
+
+#ifndef CALC_SOURCE_LOADER_THREADS_PER_CORE
+/// @brief This constant macro represents the number of loading threads spawned
+///        for each hardware thread when no number is specified: loaders spend
+///        most of their time waiting for the storage, so there are more of
+///        them than cores.
+#   define CALC_SOURCE_LOADER_THREADS_PER_CORE 4
+#endif // CALC_SOURCE_LOADER_THREADS_PER_CORE
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Loads the source files specified by a list of paths concurrently, on
+///        a pool of threads, each file with calcCreateSourceBufferFromLoadedFile.
+/// @param paths The paths to the files to load.
+/// @param count The number of paths.
+/// @param threadCount The maximum number of loading threads, 0 to use the
+///                    default one (see CALC_SOURCE_LOADER_THREADS_PER_CORE).
+/// @param encoding The encoding of the files, a BOM at their beginning takes
+///                 precedence.
+/// @return An array of count source buffers in the same order of the paths,
+///         NULL for the files that cannot be loaded. The array and the buffers
+///         must be released with calcDeleteSourceBuffers.
+CALC_API CalcSourceBuffer_t **CALC_STDCALL calcLoadSourceBuffers(const char *const *const paths, size_t count, size_t threadCount, CalcSourceEncoding_t encoding);
+
+/// @brief Deletes an array of source buffers and the buffers in it.
+/// @param sourceBuffers A pointer to the array of source buffers.
+/// @param count The number of source buffers.
+CALC_API void CALC_STDCALL calcDeleteSourceBuffers(CalcSourceBuffer_t **const sourceBuffers, size_t count);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_LOADER_H_
@@ -23,17 +23,29 @@
 
 #include <assert.h>
 
+#ifndef CALC_SOURCE_INVALID_LOC
+/// @brief This constant macro represents an invalid compact source location,
+///        no source buffer is assigned to it.
+#   define CALC_SOURCE_INVALID_LOC 0
+#endif // CALC_SOURCE_INVALID_LOC
+
 CALC_C_HEADER_BEGIN
 
-/// @brief Source location data structure.
+/// @brief Compact source location, an offset in the space shared by all the
+///        source buffers owned by a source manager (see source_manager.h).
+typedef uint32_t CalcSourceLoc_t;
+
+/// @brief Source location data structure. All its fields are 64-bit, so
+///        locations stay correct in sources larger than 4 GB or with more
+///        than 2^32 lines.
 typedef struct _CalcSourceLocation
 {
     /// @brief Current character number in the source stream.
     uint64_t ch;
-    /// @brief Current column number in the source stream.
-    uint32_t co;
+    /// @brief Current column number in the source stream, in characters.
+    uint64_t co;
     /// @brief Current line Number in the source stream.
-    uint32_t ln;
+    uint64_t ln;
 } CalcSourceLocation_t;
 
 /// @brief Sets the values of a source location.
@@ -42,7 +54,7 @@ typedef struct _CalcSourceLocation
 /// @param co The number of the column in the source buffer.
 /// @param ln The number of the line int the source buffer.
 /// @return This function returns the sourceLocation parameter.
-CALC_API_INLINE CalcSourceLocation_t *CALC_STDCALL calcSetSourceLocation(CalcSourceLocation_t *const sourceLocation, uint64_t ch, uint32_t co, uint32_t ln)
+CALC_API_INLINE CalcSourceLocation_t *CALC_STDCALL calcSetSourceLocation(CalcSourceLocation_t *const sourceLocation, uint64_t ch, uint64_t co, uint64_t ln)
 {
     assert(sourceLocation != NULL);
 
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file        source_manager.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to own
+ *              the loaded source buffers and to encode source locations as
+ *              offsets of a single 32-bit space.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_MANAGER_H_
+#define CALC_SOURCE_SOURCE_MANAGER_H_
+
+#include "calc/source/source_buffer.h"
+#include "calc/source/source_lines.h"
+#include "calc/source/source_stream.h"
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Source manager entry data structure.
+typedef struct _CalcSourceEntry
+{
+    /// @brief The path to the source file, or simply the name of the source.
+    char               *path;
+    /// @brief A pointer to the source buffer.
+    CalcSourceBuffer_t *buffer;
+    /// @brief The location of the first byte of the source buffer.
+    CalcSourceLoc_t     base;
+    /// @brief When it's set to TRUE the path string is released on manager
+    ///        deletion.
+    bool_t              cleanup;
+} CalcSourceEntry_t;
+
+/// @brief Source manager data structure. Each source buffer is assigned a
+///        contiguous range of locations (one for each byte, NUL sentinel
+///        included), in the order in which it's added.
+typedef struct _CalcSourceManager
+{
+    /// @brief The entries of the source buffers, sorted by base location.
+    CalcSourceEntry_t **entries;
+    /// @brief The number of entries.
+    size_t              count;
+    /// @brief The maximum number of entries before resizing.
+    size_t              capacity;
+    /// @brief The base location of the next source buffer.
+    CalcSourceLoc_t     next;
+} CalcSourceManager_t;
+
+/// @brief Creates a new empty source manager.
+/// @return A pointer to the new source manager.
+CALC_API CalcSourceManager_t *CALC_STDCALL calcCreateSourceManager(void);
+
+/// @brief Adds a source buffer to a source manager, that takes its ownership.
+/// @param sourceManager A pointer to the source manager.
+/// @param path The path to the source file, or simply the name of the source.
+/// @param cleanupPath When it's set to TRUE the path is released on manager
+///                    deletion.
+/// @param sourceBuffer A pointer to the source buffer to add, it must store
+///                     its whole content.
+/// @return A pointer to the new entry, or NULL if the 32-bit location space
+///         is exhausted (the buffer is not owned by the manager).
+CALC_API CalcSourceEntry_t *CALC_STDCALL calcSourceManagerAdd(CalcSourceManager_t *const sourceManager, const char *const path, bool_t cleanupPath, CalcSourceBuffer_t *const sourceBuffer);
+/// @brief Loads a source file and adds its buffer to a source manager.
+/// @param sourceManager A pointer to the source manager.
+/// @param path The path to the source file to load.
+/// @param cleanupPath When it's set to TRUE the path is released on manager
+///                    deletion.
+/// @return A pointer to the new entry, or NULL if the file cannot be loaded or
+///         the 32-bit location space is exhausted.
+CALC_API CalcSourceEntry_t *CALC_STDCALL calcSourceManagerLoadFile(CalcSourceManager_t *const sourceManager, const char *const path, bool_t cleanupPath);
+
+/// @brief Gets the compact location of a byte offset in a source buffer.
+/// @param sourceEntry A pointer to the entry of the source buffer.
+/// @param offset The byte offset in the source buffer.
+/// @return The compact location.
+CALC_API_INLINE CalcSourceLoc_t CALC_STDCALL calcGetSourceLoc(const CalcSourceEntry_t *const sourceEntry, size_t offset)
+{
+    return sourceEntry->base + (CalcSourceLoc_t)offset;
+}
+
+/// @brief Creates a new source stream that reads the source buffer of an
+///        entry, which stays owned by the source manager: the tokens scanned
+///        from the stream are located in the space of the manager.
+/// @param sourceEntry A pointer to the entry of the source buffer.
+/// @return A pointer to the new source stream, it must be deleted before the
+///         source manager.
+CALC_API CalcSourceStream_t *CALC_STDCALL calcSourceManagerCreateStream(const CalcSourceEntry_t *const sourceEntry);
+
+/// @brief Finds the entry of the source buffer to which a compact location
+///        is assigned, with a binary search on the entries.
+/// @param sourceManager A pointer to the source manager.
+/// @param sourceLoc The compact location to find.
+/// @param outOffset A pointer to a variable in which store the byte offset
+///                  of the location in the source buffer, it can be NULL.
+/// @return A pointer to the entry, or NULL if the location is not assigned.
+CALC_API CalcSourceEntry_t *CALC_STDCALL calcSourceManagerFind(const CalcSourceManager_t *const sourceManager, CalcSourceLoc_t sourceLoc, size_t *const outOffset);
+/// @brief Decodes a compact location to the path, line and column of the
+///        source to which it's assigned, using the lines index of its buffer.
+/// @param sourceManager A pointer to the source manager.
+/// @param sourceLoc The compact location to decode.
+/// @param outPath A pointer to a variable in which store the path of the
+///                source, it can be NULL.
+/// @param outLine A pointer to the structure in which store the line, its
+///                number and the column of the location.
+/// @return TRUE in case of success, FALSE if the location is not assigned.
+CALC_API bool_t CALC_STDCALL calcSourceManagerDecode(const CalcSourceManager_t *const sourceManager, CalcSourceLoc_t sourceLoc, const char **const outPath, CalcSourceLine_t *const outLine);
+
+/// @brief Deletes a source manager and all the source buffers it owns.
+/// @param sourceManager A pointer to the source manager to delete.
+CALC_API void CALC_STDCALL calcDeleteSourceManager(CalcSourceManager_t *const sourceManager);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_MANAGER_H_
@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * @file        source_piece_table.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to edit
+ *              the content of a source buffer with a piece table, tracking
+ *              the range of bytes changed by the edits.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_PIECE_TABLE_H_
+#define CALC_SOURCE_SOURCE_PIECE_TABLE_H_
+
+#include "calc/source/source_buffer.h"
+#include "calc/source/source_stream.h"
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Source piece data structure, a sequence of bytes of the original
+///        source buffer or of the bytes added by the edits.
+typedef struct _CalcSourcePiece
+{
+    /// @brief When it's set to TRUE the bytes of the piece are added bytes.
+    bool_t isAdded;
+    /// @brief The offset of the first byte of the piece.
+    size_t offset;
+    /// @brief The number of bytes of the piece.
+    size_t length;
+} CalcSourcePiece_t;
+
+/// @brief Source range data structure, the byte offsets [begin, end) of the
+///        current content of a piece table.
+typedef struct _CalcSourceRange
+{
+    /// @brief The offset of the first byte of the range.
+    size_t begin;
+    /// @brief The offset next to the last byte of the range.
+    size_t end;
+} CalcSourceRange_t;
+
+/// @brief Source piece table data structure. The original source buffer is
+///        never modified: inserted bytes are appended to a second buffer and
+///        the content is described by the sequence of the pieces.
+typedef struct _CalcSourcePieceTable
+{
+    /// @brief A pointer to the original source buffer, owned by the table.
+    CalcSourceBuffer_t *original;
+    /// @brief The bytes added by the edits.
+    byte_t             *added;
+    /// @brief The number of added bytes.
+    size_t              addedCount;
+    /// @brief The maximum number of added bytes before resizing.
+    size_t              addedCapacity;
+    /// @brief The pieces of the content, in order.
+    CalcSourcePiece_t  *pieces;
+    /// @brief The number of pieces.
+    size_t              count;
+    /// @brief The maximum number of pieces before resizing.
+    size_t              capacity;
+    /// @brief The number of bytes of the content.
+    size_t              length;
+    /// @brief When it's set to TRUE the content is changed since the changes
+    ///        have been cleared.
+    bool_t              isChanged;
+    /// @brief The smallest range that contains all the changed bytes (an
+    ///        empty range where bytes were only deleted), in the offsets of
+    ///        the current content.
+    CalcSourceRange_t   changed;
+    /// @brief The index of the piece read next by the stream of the table.
+    size_t              cursorPiece;
+    /// @brief The offset in the piece read next by the stream of the table.
+    size_t              cursorOffset;
+} CalcSourcePieceTable_t;
+
+/// @brief Creates a new piece table that edits the content of a source buffer,
+///        taking its ownership.
+/// @param sourceBuffer A pointer to the source buffer to edit.
+/// @return A pointer to the new piece table.
+CALC_API CalcSourcePieceTable_t *CALC_STDCALL calcCreateSourcePieceTable(CalcSourceBuffer_t *const sourceBuffer);
+
+/// @brief Inserts a sequence of bytes in the content of a piece table. Bytes
+///        typed one after the other extend the same piece.
+/// @param sourcePieceTable A pointer to the piece table.
+/// @param offset The offset at which insert the bytes.
+/// @param text The bytes to insert.
+/// @param count The number of bytes to insert.
+/// @return TRUE in case of success, FALSE if the offset is out of the content.
+CALC_API bool_t CALC_STDCALL calcSourcePieceTableInsert(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, const byte_t *const text, size_t count);
+/// @brief Deletes a sequence of bytes from the content of a piece table.
+/// @param sourcePieceTable A pointer to the piece table.
+/// @param offset The offset of the first byte to delete.
+/// @param count The number of bytes to delete.
+/// @return TRUE in case of success, FALSE if the bytes are out of the content.
+CALC_API bool_t CALC_STDCALL calcSourcePieceTableDelete(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, size_t count);
+
+/// @brief Gets the range changed by the edits since the last call of this
+///        function, and clears it. Only the bytes in this range (and the
+///        tokens that touch it) need to be lexed again.
+/// @param sourcePieceTable A pointer to the piece table.
+/// @param outRange A pointer to the range in which store the changed bytes.
+/// @return TRUE if the content is changed, else FALSE.
+CALC_API bool_t CALC_STDCALL calcSourcePieceTableTakeChanges(CalcSourcePieceTable_t *const sourcePieceTable, CalcSourceRange_t *const outRange);
+
+/// @brief Gets the contiguous bytes of the content from an offset to the end
+///        of its piece.
+/// @param sourcePieceTable A pointer to the piece table.
+/// @param offset The offset of the first byte of the span.
+/// @param outSpan A pointer to the span in which store the bytes, valid until
+///                the next edit.
+/// @return The number of bytes of the span, 0 at the end of the content.
+CALC_API size_t CALC_STDCALL calcSourcePieceTableGetSpan(const CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, CalcSourceSpan_t *const outSpan);
+
+/// @brief Opens a source stream that reads the content of a piece table from
+///        an offset, piece by piece. The locations of the stream are relative
+///        to the offset. The table has a single cursor, so only one stream can
+///        be read at a time, and the table must not be edited while it's read.
+/// @param sourcePieceTable A pointer to the piece table.
+/// @param offset The offset from which read the content.
+/// @param encoding The encoding of the stream.
+/// @return A pointer to the new source stream, or NULL if the offset is out
+///         of the content.
+CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenSourceStreamFromPieceTable(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, CalcSourceEncoding_t encoding);
+
+/// @brief Creates a new source buffer storing the whole content of a piece
+///        table.
+/// @param sourcePieceTable A pointer to the piece table.
+/// @return A pointer to the new source buffer.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromPieceTable(const CalcSourcePieceTable_t *const sourcePieceTable);
+
+/// @brief Deletes a piece table and its original source buffer.
+/// @param sourcePieceTable A pointer to the piece table to delete.
+CALC_API void CALC_STDCALL calcDeleteSourcePieceTable(CalcSourcePieceTable_t *const sourcePieceTable);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_PIECE_TABLE_H_
@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file        source_pool.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to
+ *              recycle source buffers and source streams, so that creating
+ *              and deleting them at high rates does no heap traffic.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_POOL_H_
+#define CALC_SOURCE_SOURCE_POOL_H_
+
+#include "calc/source/source_buffer.h"
+
+#ifndef CALC_SOURCE_POOL_MIN_SIZE
+/// @brief This constant macro represents the number of bytes of the data of
+///        the buffers of the smallest size class, it must be a power of two.
+#   define CALC_SOURCE_POOL_MIN_SIZE 64
+#endif // CALC_SOURCE_POOL_MIN_SIZE
+
+#ifndef CALC_SOURCE_POOL_CLASSES
+/// @brief This constant macro represents the number of size classes of the
+///        buffers of a source pool, each one doubles the previous one (so the
+///        largest recycled buffers are 2 MB).
+#   define CALC_SOURCE_POOL_CLASSES 16
+#endif // CALC_SOURCE_POOL_CLASSES
+
+#ifndef CALC_SOURCE_POOL_LIMIT
+/// @brief This constant macro represents the maximum number of free objects
+///        kept by a source pool for each size class (and for streams).
+#   define CALC_SOURCE_POOL_LIMIT 16
+#endif // CALC_SOURCE_POOL_LIMIT
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Source pool data structure. It keeps the released source buffers,
+///        grouped by the power-of-two size class of their data, and the
+///        released source streams, so they're reused without being zeroed.
+///        A source pool is not thread-safe: each thread should use its own.
+typedef struct _CalcSourcePool
+{
+    /// @brief The free source buffers of each size class.
+    CalcSourceBuffer_t *buffers[CALC_SOURCE_POOL_CLASSES][CALC_SOURCE_POOL_LIMIT];
+    /// @brief The number of free source buffers of each size class.
+    size_t              bufferCounts[CALC_SOURCE_POOL_CLASSES];
+    /// @brief The free source streams.
+    void               *streams[CALC_SOURCE_POOL_LIMIT];
+    /// @brief The number of free source streams.
+    size_t              streamCount;
+    /// @brief The number of objects allocated on the heap by the pool.
+    size_t              allocations;
+    /// @brief The number of objects served from the free ones.
+    size_t              reuses;
+    /// @brief The number of objects released to the pool and kept.
+    size_t              releases;
+} CalcSourcePool_t;
+
+/// @brief Creates a new empty source pool.
+/// @return A pointer to the new source pool.
+CALC_API CalcSourcePool_t *CALC_STDCALL calcCreateSourcePool(void);
+
+/// @brief Acquires a source buffer whose data can store at least size bytes,
+///        reusing a free one of its size class when it's possible. The data
+///        is not zeroed.
+/// @param sourcePool A pointer to the source pool.
+/// @param size The number of bytes of the source buffer.
+/// @return A pointer to the source buffer, to release with
+///         calcSourcePoolReleaseBuffer.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcSourcePoolAcquireBuffer(CalcSourcePool_t *const sourcePool, size_t size);
+/// @brief Releases a source buffer to a source pool. Mapped buffers, buffers
+///        out of the size classes and the ones exceeding CALC_SOURCE_POOL_LIMIT
+///        are deleted.
+/// @param sourcePool A pointer to the source pool.
+/// @param sourceBuffer A pointer to the source buffer to release.
+CALC_API void CALC_STDCALL calcSourcePoolReleaseBuffer(CalcSourcePool_t *const sourcePool, CalcSourceBuffer_t *const sourceBuffer);
+
+/// @brief Acquires the memory of a source stream, reusing a free one when it's
+///        possible. The memory is not initialized.
+/// @param sourcePool A pointer to the source pool.
+/// @param size The size of the source stream data structure.
+/// @return A pointer to the memory of the source stream.
+CALC_API void *CALC_STDCALL calcSourcePoolAcquireStream(CalcSourcePool_t *const sourcePool, size_t size);
+/// @brief Releases the memory of a source stream to a source pool.
+/// @param sourcePool A pointer to the source pool.
+/// @param sourceStream A pointer to the memory of the source stream.
+CALC_API void CALC_STDCALL calcSourcePoolReleaseStream(CalcSourcePool_t *const sourcePool, void *const sourceStream);
+
+/// @brief Creates a source buffer from a pool that will contain a specified
+///        string of bytes, like calcCreateSourceBufferFromText does.
+/// @param sourcePool A pointer to the source pool.
+/// @param text The string to wrap into the buffer.
+/// @return A pointer to the new source buffer.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreatePooledSourceBufferFromText(CalcSourcePool_t *const sourcePool, const char *const text);
+/// @brief Creates a source buffer from a pool loading the entire content of a
+///        file (never mapped), transcoded like calcCreateSourceBufferFromFile
+///        does.
+/// @param sourcePool A pointer to the source pool.
+/// @param path The path to the file to load.
+/// @param encoding The encoding of the file, a BOM at its beginning takes
+///                 precedence.
+/// @return A pointer to the new source buffer, or NULL if the file cannot be
+///         opened.
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreatePooledSourceBufferFromFile(CalcSourcePool_t *const sourcePool, const char *const path, CalcSourceEncoding_t encoding);
+
+/// @brief Deletes a source pool and all its free objects. The source streams
+///        created from the pool must be deleted before it.
+/// @param sourcePool A pointer to the source pool to delete.
+CALC_API void CALC_STDCALL calcDeleteSourcePool(CalcSourcePool_t *const sourcePool);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_POOL_H_
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file        source_prefetcher.h
+ *
+ * @author      Federico Cristina <federico.cristina@outlook.it>
+ *
+ * @copyright   Copyright (c) 2024 Federico Cristina
+ *
+ *              This file is part of the calc scripting language project,
+ *              under the Apache License v2.0. See LICENSE for license
+ *              informations.
+ *
+ * @brief       In this header are defined structures and functions to read
+ *              ahead file streams on a helper thread.
+ */
+
+#ifndef CALC_SOURCE_SOURCE_PREFETCHER_H_
+#define CALC_SOURCE_SOURCE_PREFETCHER_H_
+
+#include "calc/base/api.h"
+#include "calc/base/bits.h"
+#include "calc/base/byte.h"
+#include "calc/base/dload.h"
+#include "calc/base/file.h"
+
+#ifndef CALC_SOURCE_PREFETCHER_SEGMENTS
+/// @brief This constant macro represents the default number of segments
+///        that a prefetcher can read ahead.
+#   define CALC_SOURCE_PREFETCHER_SEGMENTS 4
+#endif // CALC_SOURCE_PREFETCHER_SEGMENTS
+
+CALC_C_HEADER_BEGIN
+
+/// @brief Prefetcher segment data structure.
+typedef struct _CalcSourceSegment
+{
+    /// @brief A pointer to the bytes of the segment.
+    byte_t *data;
+    /// @brief The number of bytes stored in the segment.
+    size_t  count;
+} CalcSourceSegment_t;
+
+/// @brief Source prefetcher data structure. A helper thread fills a bounded
+///        queue of segments reading the file stream, while the consumer
+///        empties them.
+typedef struct _CalcSourcePrefetcher
+{
+    /// @brief The file stream to read.
+    FILE                *stream;
+    /// @brief The handle of the helper thread.
+    handle_t             thread;
+    /// @brief The mutex that guards the queue.
+    handle_t             mutex;
+    /// @brief Signaled when a segment is filled.
+    handle_t             filled;
+    /// @brief Signaled when a segment is emptied.
+    handle_t             emptied;
+    /// @brief The queue of segments.
+    CalcSourceSegment_t *segments;
+    /// @brief The number of segments in the queue.
+    size_t               segmentCount;
+    /// @brief The size (in bytes) of each segment.
+    size_t               segmentSize;
+    /// @brief The number of segments filled so far.
+    size_t               head;
+    /// @brief The number of segments emptied so far.
+    size_t               tail;
+    /// @brief The number of bytes alredy consumed from the segment at the
+    ///        tail of the queue.
+    size_t               offset;
+    /// @brief When it's set to TRUE the helper thread has reached the end
+    ///        of the file stream.
+    bool_t               isExhausted;
+    /// @brief When it's set to TRUE the helper thread must stop.
+    bool_t               isStopped;
+} CalcSourcePrefetcher_t;
+
+/// @brief Creates a new prefetcher and starts to read ahead the stream.
+/// @param stream The file stream to read.
+/// @param segmentSize The size (in bytes) of each segment.
+/// @param segmentCount The maximum number of segments read ahead.
+/// @return A pointer to the new prefetcher, or NULL if the helper thread
+///         cannot be spawned.
+CALC_API CalcSourcePrefetcher_t *CALC_STDCALL calcCreateSourcePrefetcher(FILE *const stream, size_t segmentSize, size_t segmentCount);
+
+/// @brief Reads from the prefetched segments, waiting for the helper thread
+///        when they're all empty, like fread does.
+/// @param sourcePrefetcher A pointer to the prefetcher from which read.
+/// @param buffer The buffer in which copy the read bytes.
+/// @param count The number of bytes to read.
+/// @return The number of read bytes, less than count only at the end of the
+///         file stream.
+CALC_API size_t CALC_STDCALL calcSourcePrefetcherRead(CalcSourcePrefetcher_t *const sourcePrefetcher, byte_t *const buffer, size_t count);
+
+/// @brief Stops the helper thread and deletes the prefetcher. The file
+///        stream is not closed.
+/// @param sourcePrefetcher A pointer to the prefetcher to delete.
+CALC_API void CALC_STDCALL calcDeleteSourcePrefetcher(CalcSourcePrefetcher_t *const sourcePrefetcher);
+
+CALC_C_HEADER_END
+
+#endif // CALC_SOURCE_SOURCE_PREFETCHER_H_
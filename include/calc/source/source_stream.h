@@ -20,6 +20,8 @@
 
 #include "calc/source/source_buffer.h"
 #include "calc/source/source_location.h"
+#include "calc/source/source_pool.h"
+#include "calc/source/source_prefetcher.h"
 
 #ifndef CALC_DEFAULT_ENCODING
 /// @brief This constant macro represents the default encoding used by
@@ -27,8 +29,102 @@
 #   define CALC_DEFAULT_ENCODING CALC_SOURCE_ENCODING_UTF_8
 #endif // CALC_DEFAULT_ENCODING
 
+#ifndef CALC_SOURCE_STREAM_REFILL_SIZE
+/// @brief This constant macro represents the default number of bytes read
+///        from the file stream on each refill of an open source stream.
+#   define CALC_SOURCE_STREAM_REFILL_SIZE CALC_PAGESIZ
+#endif // CALC_SOURCE_STREAM_REFILL_SIZE
+
+#ifndef CALC_SOURCE_STREAM_LOOKAHEAD
+/// @brief This constant macro represents the number of decoded characters
+///        that source streams can look ahead in constant time, it must be a
+///        power of two.
+#   define CALC_SOURCE_STREAM_LOOKAHEAD 8
+#endif // CALC_SOURCE_STREAM_LOOKAHEAD
+
+#ifndef CALC_SOURCE_STREAM_SHORT_SPAN
+/// @brief This constant macro represents the number of bytes under which the
+///        locations are advanced over a span byte by byte, instead of with
+///        the vectorized scans.
+#   define CALC_SOURCE_STREAM_SHORT_SPAN 16
+#endif // CALC_SOURCE_STREAM_SHORT_SPAN
+
 CALC_C_HEADER_BEGIN
 
+/// @brief Enumeration of the classes of characters consumed by bulk reads,
+///        they can be combined together.
+typedef enum _CalcSourceClass
+{
+    /// @brief Identifier characters: ASCII letters, digits, the underscore
+    ///        and every non-ASCII byte (so UTF-8 identifiers are consumed).
+    CALC_SOURCE_CLASS_IDENTIFIER = 0x01,
+    /// @brief Decimal digits.
+    CALC_SOURCE_CLASS_DIGIT      = 0x02,
+    /// @brief Blank characters and EOLs.
+    CALC_SOURCE_CLASS_WHITESPACE = 0x04,
+} CalcSourceClass_t;
+
+/// @brief Source span data structure, a sequence of bytes consumed by a bulk
+///        read. It points into the buffer of the source stream and it's valid
+///        until the beginning of the current lexeme moves past it.
+typedef struct _CalcSourceSpan
+{
+    /// @brief A pointer to the first byte of the span.
+    const byte_t *data;
+    /// @brief The number of bytes of the span.
+    size_t        length;
+} CalcSourceSpan_t;
+
+/// @brief Source character data structure, a decoded character of the
+///        lookahead window of a source stream.
+typedef struct _CalcSourceChar
+{
+    /// @brief The value of the character, or EOF.
+    int32_t  value;
+    /// @brief The width (in bytes) of the character.
+    uint32_t width;
+} CalcSourceChar_t;
+
+/// @brief Function that reads the next block of bytes of a source, used by
+///        streams that are not backed by a file stream (e.g. sources produced
+///        by other programs or synthesized on the fly).
+/// @param context The context given when the stream was opened.
+/// @param buffer The buffer in which store the read bytes.
+/// @param count The maximum number of bytes to read.
+/// @return The number of read bytes, 0 at the end of the source.
+typedef size_t (CALC_STDCALL *CalcSourceReader_t)(void *context, byte_t *buffer, size_t count);
+
+struct _CalcSourceStream;
+
+/// @brief Function that decodes the character at a position of a source
+///        stream, storing its width in bytes.
+typedef int32_t (CALC_STDCALL *CalcSourceDecodeChar_t)(struct _CalcSourceStream *const sourceStream, uint64_t position, ssize_t *const outOffset);
+/// @brief Function that peeks or reads the next character of a source stream.
+typedef int32_t (CALC_STDCALL *CalcSourceGetChar_t)(struct _CalcSourceStream *const sourceStream);
+/// @brief Function that advances the locations of a source stream over a
+///        sequence of bytes consumed by a bulk read.
+typedef void (CALC_STDCALL *CalcSourceAdvance_t)(struct _CalcSourceStream *const sourceStream, const byte_t *const data, size_t length);
+
+/// @brief Source decoder data structure, the table of the functions of a
+///        source stream specialized for its encoding. It's chosen once when
+///        the stream is created, so reading characters never dispatches on
+///        the encoding.
+typedef struct _CalcSourceDecoder
+{
+    /// @brief The encoding decoded by the functions of the table.
+    CalcSourceEncoding_t   encoding;
+    /// @brief Decodes the character at a position, out of the runs of ASCII
+    ///        bytes.
+    CalcSourceDecodeChar_t decodeChar;
+    /// @brief Peeks the next character.
+    CalcSourceGetChar_t    peek;
+    /// @brief Reads the next character.
+    CalcSourceGetChar_t    read;
+    /// @brief Reads the next character, advancing only the byte offsets of
+    ///        the locations (see calcSetSourceStreamLazyLocations).
+    CalcSourceGetChar_t    readLazy;
+} CalcSourceDecoder_t;
+
 /// @brief Source stream data structure.
 typedef struct _CalcSourceStream
 {
@@ -38,9 +134,16 @@ typedef struct _CalcSourceStream
     /// @brief A pointer to an open file stream to use to refill the source
     ///        buffer when the cursor reaches the end.
     FILE                *stream;
-    /// @brief When it's set to TRUE the source file is treated as an
-    ///        interactive stream and is read line by line.
+    /// @brief The function used to refill the source buffer in place of the
+    ///        file stream, or NULL.
+    CalcSourceReader_t   reader;
+    /// @brief The context passed to the reader function.
+    void                *readerContext;
+    /// @brief When it's set to TRUE the source file is the stdin.
     bool_t               isStdin;
+    /// @brief When it's set to TRUE the source file is a terminal, so it's
+    ///        read line by line. Files and pipes are read in blocks.
+    bool_t               isInteractive;
     /// @brief When it's set to TRUE means that the source stream has alredy
     ///        been initialized.
     bool_t               isInitialized;
@@ -50,20 +153,107 @@ typedef struct _CalcSourceStream
     /// @brief When it's set to TRUE the path string is released on stream
     ///        deletion.
     bool_t               cleanup;
+    /// @brief A pointer to the source pool to which the stream and its buffer
+    ///        are released on deletion, or NULL.
+    CalcSourcePool_t    *pool;
     /// @brief The encoding of the source stream (the default encoding is
     ///        specified by CALC_DEFAULT_ENCODING macro).
     CalcSourceEncoding_t encoding;
+    /// @brief A pointer to the table of the functions specialized for the
+    ///        encoding of the source stream.
+    const CalcSourceDecoder_t *decoder;
     /// @brief A pointer to the source buffer data structure that stores
     ///        the content of the stream.
     CalcSourceBuffer_t  *buffer;
-    /// @brief The location in the source file stream.
+    /// @brief When it's set to TRUE the buffer is owned by someone else (e.g.
+    ///        a source manager), so it's not released on stream deletion.
+    bool_t               isShared;
+    /// @brief The compact location of the first byte of the stream, to which
+    ///        the byte offsets are added to locate its tokens. Streams whose
+    ///        buffer is not owned by a source manager are located like the
+    ///        first source of a manager.
+    CalcSourceLoc_t      base;
+    /// @brief The mask to apply to a position in the stream to get the index
+    ///        of its byte in the buffer. Open source streams use the buffer as
+    ///        a mirrored ring of a power-of-two capacity (mask + 1 bytes), so
+    ///        every sequence of at most capacity bytes is contiguous.
+    uint64_t             bufferMask;
+    /// @brief The position in the stream next to the last byte stored in the
+    ///        buffer.
+    uint64_t             bufferEnd;
+    /// @brief The position in the stream of the first byte of the last run of
+    ///        ASCII bytes found in the buffer.
+    uint64_t             asciiBegin;
+    /// @brief The position in the stream next to the last byte of the last
+    ///        run of ASCII bytes found in the buffer. Characters read inside
+    ///        the run are never decoded.
+    uint64_t             asciiEnd;
+    /// @brief The number of bytes read from the file stream on each refill.
+    size_t               refillSize;
+    /// @brief The maximum number of bytes of the buffer of an open source
+    ///        stream, or 0 when it's unbounded. Consumed bytes are overwritten
+    ///        by the next refills, so only the current lexeme is retained.
+    size_t               memoryBudget;
+    /// @brief When it's set to TRUE the current lexeme has outgrown the memory
+    ///        budget: the stream can't be refilled until a new lexeme begins.
+    bool_t               isOverflowed;
+    /// @brief When it's set to TRUE the consumer of the stream marks the
+    ///        beginning of its lexemes. Until then no lexeme is open, so open
+    ///        source streams retain only the bytes from the cursor.
+    bool_t               isLexing;
+    /// @brief A pointer to the prefetcher that reads ahead the file stream,
+    ///        or NULL when the stream is read on refill.
+    CalcSourcePrefetcher_t *prefetcher;
+    /// @brief The ring of the characters decoded ahead of the forward
+    ///        location, the first one is the next character to read.
+    CalcSourceChar_t     lookahead[CALC_SOURCE_STREAM_LOOKAHEAD];
+    /// @brief The index of the first character in the lookahead window.
+    uint32_t             lookaheadHead;
+    /// @brief The number of characters in the lookahead window.
+    uint32_t             lookaheadCount;
+    /// @brief The position in the stream next to the last character in the
+    ///        lookahead window.
+    uint64_t             lookaheadEnd;
+    /// @brief The location in the source file stream. Like the lexeme locations,
+    ///        it's never rebased on refill.
     CalcSourceLocation_t streamLocation;
     /// @brief The current lexeme beginning location.
     CalcSourceLocation_t beginLocation;
     /// @brief The current lexeme ending location.
     CalcSourceLocation_t forwardLocation;
+    /// @brief When it's set to TRUE the locations track only the byte offset
+    ///        (ch), lines and columns are computed on demand.
+    bool_t               isLazy;
+    /// @brief The function that reads the next character, chosen from the
+    ///        decoder for the location tracking mode when it's set.
+    CalcSourceGetChar_t  read;
+    /// @brief The function that advances the locations over the bytes of bulk
+    ///        reads, chosen for the location tracking mode when it's set.
+    CalcSourceAdvance_t  advance;
+    /// @brief The last location of a lazy open source stream whose line and
+    ///        column are known. It's moved to the beginning of the lexeme on
+    ///        each refill, before the bytes preceding it are overwritten.
+    CalcSourceLocation_t anchorLocation;
+    /// @brief The number of checkpoints that pin the buffer of the stream.
+    size_t               checkpointCount;
+    /// @brief The position of the oldest byte pinned by the checkpoints: open
+    ///        source streams retain it (and the following ones) on refill.
+    uint64_t             checkpointPosition;
 } CalcSourceStream_t;
 
+/// @brief Source checkpoint data structure, the state of the cursor of a
+///        source stream saved to rewind it. It's a small value, meant to be
+///        stored on the stack during a speculative parse.
+typedef struct _CalcSourceCheckpoint
+{
+    /// @brief The saved location in the source file stream.
+    CalcSourceLocation_t streamLocation;
+    /// @brief The saved lexeme beginning location.
+    CalcSourceLocation_t beginLocation;
+    /// @brief The saved lexeme ending location.
+    CalcSourceLocation_t forwardLocation;
+} CalcSourceCheckpoint_t;
+
 /// @brief Creates a new source stream using as a source to fill the buffer
 ///        a NUL-terminated string of characters.
 /// @param text The string of characters o wrap into the new source stream.
@@ -71,7 +261,7 @@ typedef struct _CalcSourceStream
 /// @return A pointer to the new source stream.
 CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromText(const char *const text, CalcSourceEncoding_t encoding);
 /// @brief Creates a new source stream filling the buffer only once loading
-///        the full content of the specified file.
+///        the full content of the specified file, transcoded into UTF-8.
 /// @param path The path to the file to load.
 /// @param cleanupPath This flag specifies if the path must be deleted.
 /// @param encoding The encoding of the stream.
@@ -84,18 +274,136 @@ CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromFile(const c
 /// @param encoding The encoding of the stream.
 /// @return A pointer to the new source stream.
 CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromStream(FILE *const stream, CalcSourceEncoding_t encoding);
+/// @brief Creates a new source stream that reads a whole source buffer owned
+///        by someone else, without copying it: the buffer is not released on
+///        stream deletion and it must outlive the stream.
+/// @param path The path to the source file, or simply the name of the source.
+/// @param sourceBuffer A pointer to the source buffer to read.
+/// @param base The compact location of the first byte of the source buffer.
+/// @return A pointer to the new source stream.
+CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromBuffer(const char *const path, CalcSourceBuffer_t *const sourceBuffer, CalcSourceLoc_t base);
+
+/// @brief Creates a new source stream, like calcCreateSourceStreamFromText
+///        does, acquiring it and its buffer from a source pool. They're
+///        released to the pool by calcDeleteSourceStream.
+/// @param sourcePool A pointer to the source pool.
+/// @param text The string of characters to wrap into the new source stream.
+/// @param encoding The encoding of the stream.
+/// @return A pointer to the new source stream.
+CALC_API CalcSourceStream_t *CALC_STDCALL calcCreatePooledSourceStreamFromText(CalcSourcePool_t *const sourcePool, const char *const text, CalcSourceEncoding_t encoding);
+/// @brief Creates a new source stream, like calcCreateSourceStreamFromFile
+///        does, acquiring it and its buffer from a source pool. They're
+///        released to the pool by calcDeleteSourceStream.
+/// @param sourcePool A pointer to the source pool.
+/// @param path The path to the file to load.
+/// @param cleanupPath This flag specifies if the path must be deleted.
+/// @param encoding The encoding of the stream.
+/// @return A pointer to the new source stream.
+CALC_API CalcSourceStream_t *CALC_STDCALL calcCreatePooledSourceStreamFromFile(CalcSourcePool_t *const sourcePool, const char *const path, bool_t cleanupPath, CalcSourceEncoding_t encoding);
 
 /// @brief Opens a new source stream from a file specified by tha path
-///        parameter.
+///        parameter. Latin-1 and UTF-16LE files are transcoded, so they're
+///        loaded whole like calcCreateSourceStreamFromFile does. The BOM at
+///        the beginning of the file is sniffed: an UTF-8 BOM is skipped and
+///        an UTF-16LE one makes the file loaded whole.
 /// @param path The path to the file to open.
 /// @param cleanupPath This flag specifies if the path must be deleted.
-/// @param encoding The encoding of the stream.
+/// @param encoding The encoding of the stream, a BOM at the beginning of the
+///                 file takes precedence.
 /// @return A pointer to the new source stream.
 CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenSourceStream(const char *const path, bool_t cleanupPath, CalcSourceEncoding_t encoding);
 /// @brief Opens the source stream that uses stdin as source file. This
-///        function is a special case of the calcOpenSourceStream function.
+///        function is a special case of the calcOpenSourceStream function:
+///        when stdin is a terminal the stream is refilled line by line,
+///        otherwise (e.g. a pipe) it's refilled in blocks.
 /// @return A pointer to the new source stream.
 CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenStandardSourceStream(void);
+/// @brief Opens a new source stream refilled by a reader function.
+/// @param name The name of the source stream.
+/// @param reader The function that reads the blocks of the source.
+/// @param context The context to pass to the reader function.
+/// @param encoding The encoding of the stream.
+/// @return A pointer to the new source stream.
+CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenSourceStreamFromReader(const char *const name, CalcSourceReader_t reader, void *const context, CalcSourceEncoding_t encoding);
+
+/// @brief Sets the number of bytes read from the file stream on each refill
+///        of an open source stream. The size is rounded up to the next power
+///        of two and the buffer grows on the next refill if it's needed.
+/// @param sourceStream A pointer to the source stream to configure.
+/// @param refillSize The number of bytes to read on each refill.
+/// @return The actual refill size.
+CALC_API size_t CALC_STDCALL calcSetSourceStreamRefillSize(CalcSourceStream_t *const sourceStream, size_t refillSize);
+/// @brief Sets the memory budget of an open source stream, the maximum number
+///        of bytes of its buffer (prefetched segments excluded). The stream
+///        can process sources of any size within the budget, as long as each
+///        lexeme fits in half of it: when a lexeme outgrows the budget the
+///        stream stops being refilled and the isOverflowed flag is set.
+/// @param sourceStream A pointer to the source stream to configure.
+/// @param memoryBudget The maximum number of bytes of the buffer, 0 to make it
+///                     unbounded.
+/// @return TRUE when the budget is set, FALSE if the stream is not open or the
+///         buffer alredy exceeds the budget.
+CALC_API bool_t CALC_STDCALL calcSetSourceStreamMemoryBudget(CalcSourceStream_t *const sourceStream, size_t memoryBudget);
+
+/// @brief Sets the location tracking mode of a source stream, before reading
+///        it. In lazy mode reads advance only the byte offsets (ch) of the
+///        locations, while lines and columns are computed on demand by
+///        calcSourceStreamResolveLocation (e.g. for diagnostics).
+/// @param sourceStream A pointer to the source stream to configure.
+/// @param isLazy TRUE to track only byte offsets, FALSE to track lines and
+///               columns on each read.
+/// @return TRUE when the mode is set, FALSE if the stream has alredy been read.
+CALC_API bool_t CALC_STDCALL calcSetSourceStreamLazyLocations(CalcSourceStream_t *const sourceStream, bool_t isLazy);
+/// @brief Computes the line and the column (in characters) of a location of a
+///        source stream from its byte offset. Whole source buffers use their
+///        lines index, open source streams count the lines from the anchor
+///        location, so the offset must not precede the current lexeme.
+/// @param sourceStream A pointer to the source stream.
+/// @param sourceLocation A pointer to the location to resolve, its ch field
+///                       is the byte offset.
+/// @return TRUE in case of success, FALSE if the offset is out of the bytes
+///         retained by the stream.
+CALC_API bool_t CALC_STDCALL calcSourceStreamResolveLocation(CalcSourceStream_t *const sourceStream, CalcSourceLocation_t *const sourceLocation);
+
+/// @brief Enables the prefetching mode of an open source stream: a helper
+///        thread reads ahead the file stream, filling a bounded queue of
+///        segments of the current refill size, so reading the file overlaps
+///        with consuming the stream. Interactive streams (terminals) can't be
+///        prefetched.
+/// @param sourceStream A pointer to the source stream to configure.
+/// @param segmentCount The maximum number of segments read ahead, when it's
+///                     0 CALC_SOURCE_PREFETCHER_SEGMENTS is used.
+/// @return TRUE when the prefetching mode is enabled, FALSE in the other cases.
+CALC_API bool_t CALC_STDCALL calcSourceStreamEnablePrefetch(CalcSourceStream_t *const sourceStream, size_t segmentCount);
+
+/// @brief Marks the current position of the stream as the beginning of the
+///        next lexeme. The bytes before the beginning of the current lexeme
+///        are no longer retained by open source streams, while the lexeme
+///        can grow across any number of refills. Consumers that never call it
+///        (nor calcSourceStreamReadLexeme) have no open lexeme: the bytes
+///        before the cursor are not retained, so the window stays bounded.
+/// @param sourceStream A pointer to the source stream.
+CALC_API void CALC_STDCALL calcSourceStreamBeginLexeme(CalcSourceStream_t *const sourceStream);
+
+/// @brief Saves the cursor and the locations of a source stream, pinning the
+///        bytes from the beginning of the current lexeme: open source streams
+///        keep them in the buffer (across any number of refills) until the
+///        checkpoint is released, so rewinding never reads the file again.
+/// @param sourceStream A pointer to the source stream.
+/// @param outCheckpoint A pointer to the checkpoint in which save the state.
+CALC_API void CALC_STDCALL calcSourceStreamCheckpoint(CalcSourceStream_t *const sourceStream, CalcSourceCheckpoint_t *const outCheckpoint);
+/// @brief Rewinds a source stream to a checkpoint that has not been released
+///        yet, restoring its cursor and its locations. The checkpoint is still
+///        pinned, so the stream can be rewound to it many times.
+/// @param sourceStream A pointer to the source stream.
+/// @param checkpoint A pointer to the checkpoint to restore.
+CALC_API void CALC_STDCALL calcSourceStreamRewind(CalcSourceStream_t *const sourceStream, const CalcSourceCheckpoint_t *const checkpoint);
+/// @brief Releases a checkpoint of a source stream, when the speculation is
+///        over (either committed or rewound). When no checkpoint is left the
+///        bytes before the current lexeme are no longer pinned.
+/// @param sourceStream A pointer to the source stream.
+/// @param checkpoint A pointer to the checkpoint to release.
+CALC_API void CALC_STDCALL calcSourceStreamReleaseCheckpoint(CalcSourceStream_t *const sourceStream, const CalcSourceCheckpoint_t *const checkpoint);
 
 /// @brief Peeks the next character of the stream and returns its value.
 /// @param sourceStream A pointer to the source stream from which peek the
@@ -108,16 +416,71 @@ CALC_API int32_t CALC_STDCALL calcSourceStreamPeek(CalcSourceStream_t *const sou
 /// @return The value of the read character.
 CALC_API int32_t CALC_STDCALL calcSourceStreamRead(CalcSourceStream_t *const sourceStream);
 
-/// @brief Peeks the character next to the specified offset from the stream.
+/// @brief Reads the maximal sequence of bytes, starting from the current
+///        position of the stream, that belong to the specified classes of
+///        characters, refilling the buffer when it's needed and updating the
+///        locations of the stream.
+/// @param sourceStream A pointer to the source stream from which read.
+/// @param classes A combination of CalcSourceClass_t values.
+/// @param outSpan A pointer to the span in which store the read bytes, it can
+///                be NULL.
+/// @return The number of read bytes.
+CALC_API size_t CALC_STDCALL calcSourceStreamReadWhile(CalcSourceStream_t *const sourceStream, int classes, CalcSourceSpan_t *const outSpan);
+/// @brief Reads the bytes of the stream until the delimiter byte (that is not
+///        consumed) or the end of the stream, refilling the buffer when it's
+///        needed and updating the locations of the stream.
+/// @param sourceStream A pointer to the source stream from which read.
+/// @param delimiter The byte that stops the read.
+/// @param outSpan A pointer to the span in which store the read bytes, it can
+///                be NULL.
+/// @return The number of read bytes.
+CALC_API size_t CALC_STDCALL calcSourceStreamReadUntil(CalcSourceStream_t *const sourceStream, byte_t delimiter, CalcSourceSpan_t *const outSpan);
+
+/// @brief Peeks the bytes stored in the buffer from the current position of
+///        the stream, refilling it until at least count bytes are stored (or
+///        the stream ends). The bytes are contiguous and nothing is consumed,
+///        so scanners can run over them and then read what they matched.
+/// @param sourceStream A pointer to the source stream from which peek.
+/// @param count The minimum number of bytes to peek.
+/// @param outSpan A pointer to the span in which store the peeked bytes, it's
+///                valid until the next refill of the stream.
+/// @return The number of peeked bytes, it's less than count only at the end
+///         of the stream.
+CALC_API size_t CALC_STDCALL calcSourceStreamPeekBytes(CalcSourceStream_t *const sourceStream, size_t count, CalcSourceSpan_t *const outSpan);
+/// @brief Reads the specified number of bytes from the stream (or the bytes
+///        left until its end), updating the locations of the stream.
+/// @param sourceStream A pointer to the source stream from which read.
+/// @param count The number of bytes to read.
+/// @param outSpan A pointer to the span in which store the read bytes, it can
+///                be NULL.
+/// @return The number of read bytes.
+CALC_API size_t CALC_STDCALL calcSourceStreamReadBytes(CalcSourceStream_t *const sourceStream, size_t count, CalcSourceSpan_t *const outSpan);
+/// @brief Skips the specified number of bytes, begins a lexeme (see
+///        calcSourceStreamBeginLexeme) and reads count bytes from the stream,
+///        all at once. Scanners call it with the bytes of a peeked span, that
+///        are never refilled.
+/// @param sourceStream A pointer to the source stream from which read.
+/// @param skip The number of bytes to skip before the lexeme.
+/// @param count The number of bytes of the lexeme.
+/// @param outSpan A pointer to the span in which store the bytes of the
+///                lexeme, it can be NULL.
+/// @return The number of read bytes of the lexeme.
+CALC_API size_t CALC_STDCALL calcSourceStreamReadLexeme(CalcSourceStream_t *const sourceStream, size_t skip, size_t count, CalcSourceSpan_t *const outSpan);
+
+/// @brief Peeks the character next to the specified offset (in characters)
+///        from the stream, refilling the buffer when it's needed. Offsets less
+///        than CALC_SOURCE_STREAM_LOOKAHEAD are served by the lookahead window,
+///        so each character is decoded once.
 /// @param sourceStream A pointer to the source stream from which peek the
 ///                     character.
-/// @param offset The offset of the character to read.
+/// @param offset The offset of the character to read, 0 is the next one.
 /// @return The value of the read character.
 CALC_API int32_t CALC_STDCALL calcSourceStreamPeekOffset(CalcSourceStream_t *const sourceStream, uint32_t offset);
-/// @brief Reads the character next to the specified offset from the stream.
+/// @brief Reads the character next to the specified offset from the stream,
+///        consuming it and every character before it.
 /// @param sourceStream A pointer to the source stream from which read the
 ///                     character.
-/// @param offset The offset of the character to read.
+/// @param offset The number of characters to read.
 /// @return The value of the read character.
 CALC_API int32_t CALC_STDCALL calcSourceStreamReadOffset(CalcSourceStream_t *const sourceStream, uint32_t offset);
 
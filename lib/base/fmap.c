@@ -0,0 +1,148 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/file.h"
+#include "calc/base/fmap.h"
+
+#if !CALC_PLATFORM_IS_WINDOWS
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+
+#   if !defined MAP_ANONYMOUS && defined MAP_ANON
+#       define MAP_ANONYMOUS MAP_ANON
+#   endif
+
+static inline size_t CALC_STDCALL calc_GetMappingLength(size_t size)
+{
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+    // One more byte is always reserved for the NUL sentinel.
+    return alignto(size + 1, pageSize);
+}
+#endif
+
+byte_t *CALC_STDCALL fmap(const char *const path, size_t *const outSize)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    // A view of a file mapping cannot exceed the size of the file, so there's
+    // no room for the NUL sentinel: callers have to load the file instead.
+    return NULL;
+#else
+    struct stat status;
+    size_t size, length;
+    void *region, *view;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+
+    if (fstat(fd, &status) || !S_ISREG(status.st_mode))
+        return close(fd), NULL;
+
+    size = (size_t)status.st_size;
+    length = calc_GetMappingLength(size);
+
+    // The whole region is reserved with anonymous zero-filled pages, then the
+    // file is mapped over its beginning: the bytes past the end of the file
+    // are always zero, either in the tail of its last page or in the reserved
+    // anonymous pages.
+    region = mmap(NULL, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (region == MAP_FAILED)
+        return close(fd), NULL;
+
+    if (size)
+    {
+        view = mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+
+        if (view == MAP_FAILED)
+            return munmap(region, length), close(fd), NULL;
+    }
+
+    close(fd);
+
+    if (outSize)
+        *outSize = size;
+
+    return (byte_t *)region;
+#endif
+}
+
+byte_t *CALC_STDCALL fload(const char *const path, size_t *const outSize)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    FILE *stream;
+    size_t size, count = 0, n;
+    byte_t *data;
+
+    if (!(stream = fopen(path, CALC_LOADMOD)))
+        return NULL;
+
+    size = fgetsiz(stream);
+    data = (byte_t *)cmalloc(size + 1);
+
+    while ((count < size) && (n = fread(data + count, sizeof(byte_t), size - count, stream)))
+        count += n;
+
+    if (ferror(stream))
+        return fclose(stream), free(data), NULL;
+
+    fclose(stream);
+#else
+    struct stat status;
+    size_t size, count = 0;
+    ssize_t n;
+    byte_t *data;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+
+    if (fstat(fd, &status) || !S_ISREG(status.st_mode))
+        return close(fd), NULL;
+
+    size = (size_t)status.st_size;
+
+#   if defined POSIX_FADV_SEQUENTIAL && defined POSIX_FADV_WILLNEED
+    // Hints are only advisory, so their failures are ignored.
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#   endif
+
+    data = (byte_t *)cmalloc(size + 1);
+
+    while (count < size)
+    {
+        if ((n = pread(fd, data + count, size - count, (off_t)count)) > 0)
+            count += (size_t)n;
+        else if (!n)
+            break; // The file shrank after fstat, its new end is loaded.
+        else if (errno != EINTR)
+            return free(data), close(fd), NULL;
+    }
+
+    close(fd);
+#endif
+
+    data[count] = NUL;
+
+    if (outSize)
+        *outSize = count;
+
+    return data;
+}
+
+bool_t CALC_STDCALL funmap(byte_t *const data, size_t size)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    return FALSE;
+#else
+    return (bool_t)!munmap((void *)data, calc_GetMappingLength(size));
+#endif
+}
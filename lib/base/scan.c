@@ -0,0 +1,244 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/scan.h"
+#include "calc/base/simd.h"
+
+size_t CALC_STDCALL bufascii(const byte_t *const buf, size_t count)
+{
+    unsigned int mask;
+    size_t i = 0;
+
+#if CALC_SIMD_AVX2
+    for (; (i + 32) <= count; i += 32)
+    {
+        if ((mask = (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(buf + i)))))
+            return i + simdctz(mask);
+    }
+#endif
+
+#if CALC_SIMD_SSE2
+    for (; (i + 16) <= count; i += 16)
+    {
+        if ((mask = (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(buf + i)))))
+            return i + simdctz(mask);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (buf[i] & 0x80)
+            return i;
+    }
+
+    (void)mask;
+
+    return count;
+}
+
+size_t CALC_STDCALL bufcount(const byte_t *const buf, size_t count, byte_t value)
+{
+#if CALC_SIMD_AVX2
+    const __m256i needle32 = _mm256_set1_epi8((char)value);
+#endif
+#if CALC_SIMD_SSE2
+    const __m128i needle16 = _mm_set1_epi8((char)value);
+#endif
+    size_t result = 0, i = 0;
+
+#if CALC_SIMD_AVX2
+    for (; (i + 32) <= count; i += 32)
+        result += simdpopcnt((unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(buf + i)), needle32)));
+#endif
+
+#if CALC_SIMD_SSE2
+    for (; (i + 16) <= count; i += 16)
+        result += simdpopcnt((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + i)), needle16)));
+#endif
+
+    for (; i < count; i++)
+        result += (buf[i] == value);
+
+    return result;
+}
+
+size_t CALC_STDCALL bufchars(const byte_t *const buf, size_t count)
+{
+    // Continuation bytes are the signed bytes less than -64.
+#if CALC_SIMD_AVX2
+    const __m256i bound32 = _mm256_set1_epi8(-64);
+#endif
+#if CALC_SIMD_SSE2
+    const __m128i bound16 = _mm_set1_epi8(-64);
+#endif
+    size_t result = count, i = 0;
+
+#if CALC_SIMD_AVX2
+    for (; (i + 32) <= count; i += 32)
+        result -= simdpopcnt((unsigned int)_mm256_movemask_epi8(_mm256_cmpgt_epi8(bound32, _mm256_loadu_si256((const __m256i *)(buf + i)))));
+#endif
+
+#if CALC_SIMD_SSE2
+    for (; (i + 16) <= count; i += 16)
+        result -= simdpopcnt((unsigned int)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_loadu_si128((const __m128i *)(buf + i)), bound16)));
+#endif
+
+    for (; i < count; i++)
+        result -= ((buf[i] & 0xC0) == 0x80);
+
+    return result;
+}
+
+/// @brief Tests if a byte is a blank: a space or a byte from '\t' to '\r'.
+#define calc_IsBlank(c) (((c) == ' ') || ((byte_t)((c) - '\t') <= ('\r' - '\t')))
+/// @brief Tests if a byte can be part of an identifier: a letter, a digit, an
+///        underscore or a non-ASCII byte.
+#define calc_IsIdent(c) (((byte_t)(((c) | 0x20) - 'a') <= ('z' - 'a')) || ((byte_t)((c) - '0') <= 9) || ((c) == '_') || ((c) & 0x80))
+
+size_t CALC_STDCALL bufblanks(const byte_t *const buf, size_t count)
+{
+    // Bytes from '\t' to '\r' are the ones that, minus '\t', are not above
+    // 4 as unsigned bytes.
+#if CALC_SIMD_AVX2
+    const __m256i space32 = _mm256_set1_epi8(' '), tab32 = _mm256_set1_epi8('\t'), range32 = _mm256_set1_epi8('\r' - '\t');
+    __m256i block32, offset32;
+#endif
+#if CALC_SIMD_SSE2
+    const __m128i space16 = _mm_set1_epi8(' '), tab16 = _mm_set1_epi8('\t'), range16 = _mm_set1_epi8('\r' - '\t');
+    __m128i block16, offset16;
+#endif
+    unsigned int mask;
+    size_t i = 0;
+
+#if CALC_SIMD_AVX2
+    for (; (i + 32) <= count; i += 32)
+    {
+        block32 = _mm256_loadu_si256((const __m256i *)(buf + i));
+        offset32 = _mm256_sub_epi8(block32, tab32);
+
+        if ((mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block32, space32), _mm256_cmpeq_epi8(_mm256_min_epu8(offset32, range32), offset32)))))
+            return i + simdctz(mask);
+    }
+#endif
+
+#if CALC_SIMD_SSE2
+    for (; (i + 16) <= count; i += 16)
+    {
+        block16 = _mm_loadu_si128((const __m128i *)(buf + i));
+        offset16 = _mm_sub_epi8(block16, tab16);
+
+        if ((mask = ~(unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block16, space16), _mm_cmpeq_epi8(_mm_min_epu8(offset16, range16), offset16))) & 0xFFFF))
+            return i + simdctz(mask);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (!calc_IsBlank(buf[i]))
+            return i;
+    }
+
+    (void)mask;
+
+    return count;
+}
+
+size_t CALC_STDCALL bufident(const byte_t *const buf, size_t count)
+{
+    // Letters are the bytes that, lowered and minus 'a', are not above 25 as
+    // unsigned bytes; digits the ones that, minus '0', are not above 9.
+#if CALC_SIMD_AVX2
+    const __m256i lower32 = _mm256_set1_epi8(0x20), a32 = _mm256_set1_epi8('a'), letters32 = _mm256_set1_epi8('z' - 'a');
+    const __m256i zero32 = _mm256_set1_epi8('0'), digits32 = _mm256_set1_epi8(9), underscore32 = _mm256_set1_epi8('_');
+    __m256i block32, letter32, digit32;
+#endif
+#if CALC_SIMD_SSE2
+    const __m128i lower16 = _mm_set1_epi8(0x20), a16 = _mm_set1_epi8('a'), letters16 = _mm_set1_epi8('z' - 'a');
+    const __m128i zero16 = _mm_set1_epi8('0'), digits16 = _mm_set1_epi8(9), underscore16 = _mm_set1_epi8('_');
+    __m128i block16, letter16, digit16;
+#endif
+    unsigned int mask;
+    size_t i = 0;
+
+#if CALC_SIMD_AVX2
+    for (; (i + 32) <= count; i += 32)
+    {
+        block32 = _mm256_loadu_si256((const __m256i *)(buf + i));
+        letter32 = _mm256_sub_epi8(_mm256_or_si256(block32, lower32), a32);
+        digit32 = _mm256_sub_epi8(block32, zero32);
+
+        // Non-ASCII bytes are the ones with the sign bit, movemask takes it.
+        letter32 = _mm256_cmpeq_epi8(_mm256_min_epu8(letter32, letters32), letter32);
+        digit32 = _mm256_cmpeq_epi8(_mm256_min_epu8(digit32, digits32), digit32);
+
+        if ((mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter32, digit32), _mm256_or_si256(_mm256_cmpeq_epi8(block32, underscore32), block32)))))
+            return i + simdctz(mask);
+    }
+#endif
+
+#if CALC_SIMD_SSE2
+    for (; (i + 16) <= count; i += 16)
+    {
+        block16 = _mm_loadu_si128((const __m128i *)(buf + i));
+        letter16 = _mm_sub_epi8(_mm_or_si128(block16, lower16), a16);
+        digit16 = _mm_sub_epi8(block16, zero16);
+
+        letter16 = _mm_cmpeq_epi8(_mm_min_epu8(letter16, letters16), letter16);
+        digit16 = _mm_cmpeq_epi8(_mm_min_epu8(digit16, digits16), digit16);
+
+        if ((mask = ~(unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter16, digit16), _mm_or_si128(_mm_cmpeq_epi8(block16, underscore16), block16))) & 0xFFFF))
+            return i + simdctz(mask);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (!calc_IsIdent(buf[i]))
+            return i;
+    }
+
+    (void)mask;
+
+    return count;
+}
+
+size_t CALC_STDCALL bufuntil(const byte_t *const buf, size_t count, byte_t value)
+{
+#if CALC_SIMD_AVX2
+    const __m256i needle32 = _mm256_set1_epi8((char)value);
+#endif
+#if CALC_SIMD_SSE2
+    const __m128i needle16 = _mm_set1_epi8((char)value);
+#endif
+    unsigned int mask;
+    size_t i = 0;
+
+#if CALC_SIMD_AVX2
+    for (; (i + 32) <= count; i += 32)
+    {
+        if ((mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(buf + i)), needle32))))
+            return i + simdctz(mask);
+    }
+#endif
+
+#if CALC_SIMD_SSE2
+    for (; (i + 16) <= count; i += 16)
+    {
+        if ((mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + i)), needle16))))
+            return i + simdctz(mask);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (buf[i] == value)
+            return i;
+    }
+
+    (void)mask;
+
+    return count;
+}
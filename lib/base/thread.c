@@ -0,0 +1,210 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/thread.h"
+
+#if CALC_PLATFORM_IS_WINDOWS
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <unistd.h>
+#endif
+
+/// @brief Thread startup data structure.
+typedef struct _calc_thread
+{
+    /// @brief The routine to run.
+    thrdfunc_t func;
+    /// @brief The argument of the routine.
+    void      *arg;
+#if CALC_PLATFORM_IS_WINDOWS
+    /// @brief The native thread handle.
+    HANDLE     handle;
+#else
+    /// @brief The native thread handle.
+    pthread_t  handle;
+#endif
+} calc_thread_t;
+
+#if CALC_PLATFORM_IS_WINDOWS
+static DWORD WINAPI calc_ThreadStart(LPVOID param)
+{
+    calc_thread_t *thread = (calc_thread_t *)param;
+
+    thread->func(thread->arg);
+
+    return 0;
+}
+#else
+static void *calc_ThreadStart(void *param)
+{
+    calc_thread_t *thread = (calc_thread_t *)param;
+
+    thread->func(thread->arg);
+
+    return NULL;
+}
+#endif
+
+handle_t CALC_STDCALL thrdspawn(thrdfunc_t func, void *arg)
+{
+    calc_thread_t *thread = alloc(calc_thread_t);
+
+    thread->func = func;
+    thread->arg = arg;
+
+#if CALC_PLATFORM_IS_WINDOWS
+    if (!(thread->handle = CreateThread(NULL, 0, calc_ThreadStart, (LPVOID)thread, 0, NULL)))
+#else
+    if (pthread_create(&thread->handle, NULL, calc_ThreadStart, (void *)thread))
+#endif
+        return freeret(thread, NULL);
+
+    return (handle_t)thread;
+}
+
+bool_t CALC_STDCALL thrdjoin(handle_t thread)
+{
+    calc_thread_t *self = (calc_thread_t *)thread;
+    bool_t result;
+
+#if CALC_PLATFORM_IS_WINDOWS
+    result = (bool_t)(WaitForSingleObject(self->handle, INFINITE) == WAIT_OBJECT_0);
+    CloseHandle(self->handle);
+#else
+    result = (bool_t)!pthread_join(self->handle, NULL);
+#endif
+
+    free(self);
+
+    return result;
+}
+
+unsigned int CALC_STDCALL thrdcount(void)
+{
+    long count;
+
+#if CALC_PLATFORM_IS_WINDOWS
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    count = (long)info.dwNumberOfProcessors;
+#elif defined _SC_NPROCESSORS_ONLN
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    count = 1;
+#endif
+
+    return (count < 1) ? 1 : (unsigned int)count;
+}
+
+handle_t CALC_STDCALL mtxcreate(void)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    SRWLOCK *mutex = alloc(SRWLOCK);
+
+    InitializeSRWLock(mutex);
+#else
+    pthread_mutex_t *mutex = alloc(pthread_mutex_t);
+
+    pthread_mutex_init(mutex, NULL);
+#endif
+
+    return (handle_t)mutex;
+}
+
+void CALC_STDCALL mtxlock(handle_t mutex)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    AcquireSRWLockExclusive((SRWLOCK *)mutex);
+#else
+    pthread_mutex_lock((pthread_mutex_t *)mutex);
+#endif
+
+    return;
+}
+
+void CALC_STDCALL mtxunlock(handle_t mutex)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    ReleaseSRWLockExclusive((SRWLOCK *)mutex);
+#else
+    pthread_mutex_unlock((pthread_mutex_t *)mutex);
+#endif
+
+    return;
+}
+
+void CALC_STDCALL mtxdelete(handle_t mutex)
+{
+#if !CALC_PLATFORM_IS_WINDOWS
+    pthread_mutex_destroy((pthread_mutex_t *)mutex);
+#endif
+
+    free(mutex);
+
+    return;
+}
+
+handle_t CALC_STDCALL cndcreate(void)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    CONDITION_VARIABLE *cond = alloc(CONDITION_VARIABLE);
+
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_t *cond = alloc(pthread_cond_t);
+
+    pthread_cond_init(cond, NULL);
+#endif
+
+    return (handle_t)cond;
+}
+
+void CALC_STDCALL cndwait(handle_t cond, handle_t mutex)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    SleepConditionVariableSRW((CONDITION_VARIABLE *)cond, (SRWLOCK *)mutex, INFINITE, 0);
+#else
+    pthread_cond_wait((pthread_cond_t *)cond, (pthread_mutex_t *)mutex);
+#endif
+
+    return;
+}
+
+void CALC_STDCALL cndsignal(handle_t cond)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    WakeConditionVariable((CONDITION_VARIABLE *)cond);
+#else
+    pthread_cond_signal((pthread_cond_t *)cond);
+#endif
+
+    return;
+}
+
+void CALC_STDCALL cndbroadcast(handle_t cond)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    WakeAllConditionVariable((CONDITION_VARIABLE *)cond);
+#else
+    pthread_cond_broadcast((pthread_cond_t *)cond);
+#endif
+
+    return;
+}
+
+void CALC_STDCALL cnddelete(handle_t cond)
+{
+#if !CALC_PLATFORM_IS_WINDOWS
+    pthread_cond_destroy((pthread_cond_t *)cond);
+#endif
+
+    free(cond);
+
+    return;
+}
@@ -10,6 +10,8 @@
  */
 
 #include "calc/base/error.h"
+#include "calc/base/scan.h"
+#include "calc/base/simd.h"
 #include "calc/base/utf8.h"
 
 const char *CALC_STDCALL utf8_errmsg(ssize_t errcode)
@@ -162,6 +164,29 @@ ssize_t CALC_STDCALL utf8_iterate(
     return 4;
 }
 
+size_t CALC_STDCALL utf8_validate(const uint8_t *str, size_t strlen)
+{
+    int32_t uc;
+    ssize_t length;
+    size_t i = 0;
+
+    while (i < strlen)
+    {
+        if (str[i] < 0x80)
+        {
+            i += bufascii(str + i, strlen - i);
+            continue;
+        }
+
+        if ((length = utf8_iterate(str + i, (ssize_t)(strlen - i), &uc)) < 0)
+            return i;
+
+        i += length;
+    }
+
+    return strlen;
+}
+
 bool_t CALC_STDCALL utf8_codepoint_valid(int32_t uc)
 {
     return (((uint32_t)uc) - 0xd800 > 0x07ff) && ((uint32_t)uc < 0x110000);
@@ -205,6 +230,87 @@ ssize_t CALC_STDCALL utf8_encode_char(int32_t uc, uint8_t *dst)
         return 0;
 }
 
+size_t CALC_STDCALL utf8_from_latin1(const uint8_t *src, size_t count, uint8_t *dst)
+{
+    size_t i = 0, j = 0, run;
+
+    while (i < count)
+    {
+        if ((run = bufascii(src + i, count - i)) != 0)
+        {
+            bufcpy(dst + j, src + i, run);
+
+            i += run;
+            j += run;
+
+            continue;
+        }
+
+        // Latin-1 bytes are the codepoints from U+0080 to U+00FF.
+        dst[j++] = (uint8_t)(0xC0 | (src[i] >> 6));
+        dst[j++] = (uint8_t)(0x80 | (src[i] & 0x3F));
+        i++;
+    }
+
+    return j;
+}
+
+size_t CALC_STDCALL utf8_from_utf16le(const uint8_t *src, size_t count, uint8_t *dst)
+{
+    size_t i = 0, j = 0;
+    int32_t uc, lo;
+
+#if CALC_SIMD_SSE2
+    const __m128i ascii = _mm_set1_epi16((short)0xFF80);
+    __m128i units;
+#endif
+
+    while ((i + 1) < count)
+    {
+#if CALC_SIMD_SSE2
+        // Eight ASCII code units are narrowed to eight bytes at once.
+        if ((i + 16) <= count)
+        {
+            units = _mm_loadu_si128((const __m128i *)(src + i));
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, ascii), _mm_setzero_si128())) == 0xFFFF)
+            {
+                _mm_storel_epi64((__m128i *)(dst + j), _mm_packus_epi16(units, units));
+
+                i += 16;
+                j += 8;
+
+                continue;
+            }
+        }
+#endif
+
+        uc = src[i] | (src[i + 1] << 8);
+        i += 2;
+
+        if ((uc >= 0xD800) && (uc < 0xDC00))
+        {
+            lo = ((i + 1) < count) ? (src[i] | (src[i + 1] << 8)) : 0;
+
+            if ((lo >= 0xDC00) && (lo < 0xE000))
+                uc = 0x10000 + ((uc - 0xD800) << 10) + (lo - 0xDC00), i += 2;
+            else
+                uc = 0xFFFD;
+        }
+        else if ((uc >= 0xDC00) && (uc < 0xE000))
+        {
+            uc = 0xFFFD;
+        }
+
+        j += (size_t)utf8_encode_char(uc, dst + j);
+    }
+
+    if (i < count)
+        j += (size_t)utf8_encode_char(0xFFFD, dst + j);
+
+    return j;
+}
+
 /* internal version used for inserting 0xff bytes between graphemes */
 static ssize_t CALC_STDCALL charbound_encode_char(int32_t uc, uint8_t *dst)
 {
@@ -0,0 +1,206 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+/* Generator of the perfect hash of the keywords: it collects the keywords
+ * defined in tokens.inc (global, object, property and directive ones) and
+ * searches the values associated to their first and last characters, so that
+ * the length plus the values of the first and the last character of each
+ * keyword is a different slot of the table. The table is written in the file
+ * specified by the first argument. It runs at build time, each time that
+ * tokens.inc changes.
+ */
+
+#include "calc/lex/tokens.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CALC_KEYWORDS_GEN_MAX_ATTEMPTS
+/// @brief The maximum number of changes of the associated values tried for
+///        each size of the table.
+#   define CALC_KEYWORDS_GEN_MAX_ATTEMPTS 1000000
+#endif // CALC_KEYWORDS_GEN_MAX_ATTEMPTS
+
+/// @brief A keyword, as defined in tokens.inc.
+typedef struct _CalcKeyword
+{
+    CalcTokenCode_t code;
+    const char     *name;
+    const char     *lexeme;
+} CalcKeyword_t;
+
+static const CalcKeyword_t calc_Keywords[] = {
+#define calcDefineToken(name)
+#define calcDefineTokenWithLexeme(name, lexeme)
+#define calcDefineKeywordToken(name, lexeme) { name, #name, lexeme },
+
+#include CALC_LEX_TOKENS_INC_
+
+#undef calcDefineToken
+};
+
+/// @brief The number of keywords.
+#define CALC_KEYWORD_COUNT ((int)(sizeof(calc_Keywords) / sizeof(*calc_Keywords)))
+
+static unsigned int calc_Values[256];
+static int          calc_Slots[1024];
+static unsigned int calc_Seed = 0x43414C43;
+
+static void calc_Fail(const char *const message)
+{
+    fprintf(stderr, "calc-keywords-gen: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/// @brief A deterministic pseudo-random generator, so the same tokens.inc
+///        always generates the same table.
+static unsigned int calc_Random(void)
+{
+    calc_Seed = (calc_Seed * 1103515245u) + 12345u;
+
+    return calc_Seed >> 8;
+}
+
+static unsigned int calc_Hash(const char *const lexeme, unsigned int size)
+{
+    size_t length = strlen(lexeme);
+
+    return (unsigned int)(length + calc_Values[(unsigned char)lexeme[0]] + calc_Values[(unsigned char)lexeme[length - 1]]) & (size - 1);
+}
+
+/// @brief Places all the keywords in the table.
+/// @return The index of a keyword that collides with another one, or -1 if
+///         the hash is perfect.
+static int calc_Place(unsigned int size)
+{
+    unsigned int slot;
+    int i;
+
+    for (slot = 0; slot < size; slot++)
+        calc_Slots[slot] = -1;
+
+    for (i = 0; i < CALC_KEYWORD_COUNT; i++)
+    {
+        slot = calc_Hash(calc_Keywords[i].lexeme, size);
+
+        if (calc_Slots[slot] >= 0)
+            return i;
+
+        calc_Slots[slot] = i;
+    }
+
+    return -1;
+}
+
+/// @brief Searches the associated values for a table of the specified size,
+///        changing the value of a character of a colliding keyword each time.
+static int calc_Search(unsigned int size)
+{
+    const char *lexeme;
+    long attempts;
+    int i;
+
+    memset(calc_Values, 0, sizeof(calc_Values));
+
+    for (attempts = 0; attempts < CALC_KEYWORDS_GEN_MAX_ATTEMPTS; attempts++)
+    {
+        if ((i = calc_Place(size)) < 0)
+            return 1;
+
+        lexeme = calc_Keywords[i].lexeme;
+
+        if (calc_Random() & 1)
+            calc_Values[(unsigned char)lexeme[0]] = calc_Random() & (size - 1);
+        else
+            calc_Values[(unsigned char)lexeme[strlen(lexeme) - 1]] = calc_Random() & (size - 1);
+    }
+
+    return 0;
+}
+
+static void calc_WriteTable(FILE *const stream, unsigned int size)
+{
+    size_t length, minLength = (size_t)-1, maxLength = 0;
+    unsigned int slot;
+    int i;
+
+    for (i = 0; i < CALC_KEYWORD_COUNT; i++)
+    {
+        length = strlen(calc_Keywords[i].lexeme);
+
+        if (length < minLength)
+            minLength = length;
+        if (length > maxLength)
+            maxLength = length;
+    }
+
+    fprintf(stream, "/**                                                                     -*- C -*-\n");
+    fprintf(stream, " * @file        keywords_hash.inc\n");
+    fprintf(stream, " *\n");
+    fprintf(stream, " * @brief       This file is generated by calc-keywords-gen from tokens.inc, do\n");
+    fprintf(stream, " *              not edit it. It defines the perfect hash of the %d keywords:\n", CALC_KEYWORD_COUNT);
+    fprintf(stream, " *              a table of %u slots.\n", size);
+    fprintf(stream, " */\n\n");
+
+    fprintf(stream, "#ifndef CALC_LEX_KEYWORDS_HASH_INC_\n#define CALC_LEX_KEYWORDS_HASH_INC_\n\n");
+
+    fprintf(stream, "/// @brief The number of slots of the table, it's a power of two.\n");
+    fprintf(stream, "#define CALC_KEYWORDS_HASH_SIZE %u\n", size);
+    fprintf(stream, "/// @brief The length of the shortest keyword.\n");
+    fprintf(stream, "#define CALC_KEYWORDS_MIN_LENGTH %u\n", (unsigned int)minLength);
+    fprintf(stream, "/// @brief The length of the longest keyword.\n");
+    fprintf(stream, "#define CALC_KEYWORDS_MAX_LENGTH %u\n\n", (unsigned int)maxLength);
+
+    fprintf(stream, "/// @brief The value associated to each character, the slot of a keyword is\n");
+    fprintf(stream, "///        its length plus the values of its first and last characters.\n");
+    fprintf(stream, "static const uint16_t calc_KeywordValues[256] = {");
+
+    for (i = 0; i < 256; i++)
+        fprintf(stream, "%s%3u,", (i % 16) ? " " : "\n    ", calc_Values[i]);
+
+    fprintf(stream, "\n};\n\n");
+
+    fprintf(stream, "/// @brief The keyword stored in each slot.\n");
+    fprintf(stream, "static const struct\n{\n    const char     *lexeme;\n    size_t          length;\n    CalcTokenCode_t code;\n} calc_KeywordSlots[CALC_KEYWORDS_HASH_SIZE] = {\n");
+
+    for (slot = 0; slot < size; slot++)
+    {
+        if ((i = calc_Slots[slot]) < 0)
+            fprintf(stream, "    { NULL, 0, CALC_TOKEN_INVALID },\n");
+        else
+            fprintf(stream, "    { \"%s\", %u, %s },\n", calc_Keywords[i].lexeme, (unsigned int)strlen(calc_Keywords[i].lexeme), calc_Keywords[i].name);
+    }
+
+    fprintf(stream, "};\n\n#endif // CALC_LEX_KEYWORDS_HASH_INC_\n");
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int size;
+    FILE *stream;
+
+    if (argc < 2)
+        calc_Fail("usage: calc-keywords-gen <output>");
+
+    // The smallest power of two that is at least twice the keywords.
+    for (size = 2; size < (unsigned int)(CALC_KEYWORD_COUNT * 2); size <<= 1)
+        ;
+
+    while (!calc_Search(size))
+    {
+        if ((size <<= 1) > (sizeof(calc_Slots) / sizeof(*calc_Slots)))
+            calc_Fail("no perfect hash found, two keywords share length, first and last characters");
+    }
+
+    if (!(stream = fopen(argv[1], "w")))
+        calc_Fail("cannot open the output file");
+
+    calc_WriteTable(stream, size);
+    fclose(stream);
+
+    return EXIT_SUCCESS;
+}
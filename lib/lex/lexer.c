@@ -0,0 +1,285 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/scan.h"
+#include "calc/base/string.h"
+
+#include "calc/lex/lexer.h"
+
+// Generated by calc-lexer-gen from tokens.inc.
+#include "lexer_tables.inc"
+
+CALC_API CalcLexer_t *CALC_STDCALL calcCreateLexer(CalcSourceStream_t *const sourceStream)
+{
+    assert(sourceStream != NULL);
+
+    CalcLexer_t *lexer = alloc(CalcLexer_t);
+
+    lexer->sourceStream = sourceStream;
+    lexer->window.data = NULL;
+    lexer->window.length = 0;
+    lexer->windowPosition = 0;
+    lexer->windowEnd = 0;
+
+    return lexer;
+}
+
+/// @brief Peeks the bytes from the current position of the stream, reusing
+///        the window of the lexer while the stream is inside of it and it has
+///        not been refilled.
+/// @return The number of peeked bytes, 0 at the end of the stream.
+static inline size_t CALC_STDCALL calc_LexerPeek(CalcLexer_t *const lexer, size_t count, CalcSourceSpan_t *const outWindow)
+{
+    CalcSourceStream_t *sourceStream = lexer->sourceStream;
+    uint64_t position = sourceStream->forwardLocation.ch;
+
+    if ((sourceStream->bufferEnd != lexer->windowEnd) || (position < lexer->windowPosition) || ((position - lexer->windowPosition) >= lexer->window.length) || ((lexer->window.length - (size_t)(position - lexer->windowPosition)) < count))
+    {
+        calcSourceStreamPeekBytes(sourceStream, count, &lexer->window);
+
+        lexer->windowPosition = position;
+        lexer->windowEnd = sourceStream->bufferEnd;
+    }
+
+    outWindow->data = lexer->window.data + (size_t)(position - lexer->windowPosition);
+    outWindow->length = lexer->window.length - (size_t)(position - lexer->windowPosition);
+
+    return outWindow->length;
+}
+
+/// @brief Runs the DFA over the bytes of a window from the specified offset,
+///        until no token can be matched or the window ends. The state and the
+///        last accepting state (with the length of its lexeme) are kept in
+///        locals, so the hot loop does one lookup of the next state for each
+///        byte and nothing else touches memory, except for the runs that
+///        are skipped by the kernels of scan.h.
+/// @return The offset at which the scan stopped.
+static inline size_t CALC_STDCALL calc_LexerScan(const byte_t *const data, size_t length, size_t offset, calc_LexerState_t *const state, calc_LexerState_t *const accepted, size_t *const acceptedLength)
+{
+    calc_LexerState_t current = *state, last = *accepted;
+    size_t lastLength = *acceptedLength, i;
+
+    for (i = offset; i < length; i++)
+    {
+        if ((current = calc_LexerTransitions[current + calc_LexerClasses[data[i]]]) == CALC_LEXER_STATE_DEAD)
+            break;
+
+        if (current >= CALC_LEXER_STATE_ACCEPTING)
+        {
+            // Identifiers and line comments loop in their states, their runs
+            // are skipped at once.
+            if (current == CALC_LEXER_STATE_IDENT)
+                i += bufident(data + i + 1, length - i - 1);
+            else if (current == CALC_LEXER_STATE_LINE_COMMENT)
+                i += bufuntil(data + i + 1, length - i - 1, EOL);
+
+            last = current;
+            lastLength = i + 1;
+        }
+    }
+
+    *state = current;
+    *accepted = last;
+    *acceptedLength = lastLength;
+
+    return i;
+}
+
+/// @brief Chooses the token matched by a scan from the specified offset, and
+///        the length of its lexeme.
+/// @param accepted The last accepting state of the scan.
+/// @param offset The offset at which the scan started.
+/// @param stop The offset at which the scan stopped.
+/// @param length A pointer to the offset next to the last accepted byte, it's
+///               replaced by the length of the lexeme.
+/// @return The code of the matched token.
+static inline CalcTokenCode_t CALC_STDCALL calc_LexerAccept(calc_LexerState_t accepted, size_t offset, size_t stop, size_t *const length)
+{
+    if (accepted != CALC_LEXER_STATE_DEAD)
+    {
+        *length -= offset;
+
+        return (CalcTokenCode_t)calc_LexerAccepts[accepted / CALC_LEXER_CLASS_COUNT];
+    }
+    else
+    {
+        // Invalid bytes are skipped up to the point where the scan stopped,
+        // so an unterminated literal is a single token.
+        *length = max(stop - offset, 1);
+
+        return CALC_TOKEN_INVALID;
+    }
+}
+
+/// @brief Finds the keyword matched as an identifier: keywords are not in the
+///        DFA, so identifiers are looked up in the perfect hash of the keywords
+///        once they're accepted. Contextual keywords are reported as
+///        identifiers that may be keywords, the parser chooses.
+/// @return The code of the keyword, or the specified code.
+static inline CalcTokenCode_t CALC_STDCALL calc_LexerKeyword(CalcTokenCode_t code, const byte_t *const data, size_t length)
+{
+    CalcTokenCode_t keyword;
+
+    if ((code != CALC_TOKEN_IDENT) || ((keyword = calcGetKeywordToken((const char *)data, length)) == CALC_TOKEN_INVALID))
+        return code;
+    else if ((keyword >= CALC_TOKEN_KEYWORD_ASYNC) && (keyword <= CALC_TOKEN_KEYWORD_YIELD))
+        return keyword;
+    else
+        return CALC_TOKEN_IDENT_OR_KWORD;
+}
+
+CALC_API CalcTokenCode_t CALC_STDCALL calcLexerMatch(const byte_t *const data, size_t length, size_t *const outLength)
+{
+    calc_LexerState_t state = CALC_LEXER_STATE_START, accepted = CALC_LEXER_STATE_DEAD;
+    CalcTokenCode_t code;
+    size_t stop;
+
+    *outLength = 0;
+    stop = calc_LexerScan(data, length, 0, &state, &accepted, outLength);
+    code = calc_LexerAccept(accepted, 0, stop, outLength);
+
+    return calc_LexerKeyword(code, data, *outLength);
+}
+
+/// @brief Scans the next token of a stream that reads a whole source buffer.
+///        The window is the whole content, that is never refilled: the DFA
+///        runs over the buffer directly and the stream is advanced once for
+///        each token, over the blanks before it too.
+static inline CalcTokenCode_t CALC_STDCALL calc_LexerNextTokenWhole(CalcSourceStream_t *const sourceStream, CalcSourceSpan_t *const outLexeme)
+{
+    const byte_t *data = sourceStream->buffer->data;
+    size_t end = sourceStream->bufferEnd ? (size_t)(sourceStream->bufferEnd - 1) : 0, position, start, stop, length;
+    calc_LexerState_t state, accepted;
+    CalcTokenCode_t code;
+
+    do
+    {
+        start = position = (size_t)sourceStream->forwardLocation.ch;
+
+        // Most of the tokens are separated by a single blank, or none.
+        if ((position < end) && (calc_LexerClasses[data[position]] <= CALC_LEXER_CLASS_EOL))
+        {
+            if ((++position < end) && (calc_LexerClasses[data[position]] <= CALC_LEXER_CLASS_EOL))
+                position += bufblanks(data + position, end - position);
+        }
+
+        if (position >= end)
+        {
+            calcSourceStreamReadBytes(sourceStream, position - start, NULL);
+            calcSourceStreamBeginLexeme(sourceStream);
+
+            return CALC_TOKEN_TRIVIAL_ENDOF;
+        }
+
+        state = CALC_LEXER_STATE_START;
+        accepted = CALC_LEXER_STATE_DEAD;
+        length = 0;
+
+        stop = calc_LexerScan(data, end, position, &state, &accepted, &length);
+        code = calc_LexerAccept(accepted, position, stop, &length);
+        code = calc_LexerKeyword(code, data + position, length);
+
+        calcSourceStreamReadLexeme(sourceStream, position - start, length, outLexeme);
+    } while (code == CALC_TOKEN_TRIVIAL_REMLN);
+
+    return code;
+}
+
+/// @brief Scans the next token of an open stream, in the windows peeked from
+///        its ring.
+static CalcTokenCode_t CALC_STDCALL calc_LexerNextTokenOpen(CalcLexer_t *const lexer, CalcSourceSpan_t *const outLexeme)
+{
+    CalcSourceStream_t *sourceStream = lexer->sourceStream;
+    CalcTokenCode_t code;
+    CalcSourceSpan_t window;
+    calc_LexerState_t state, accepted;
+    size_t i, skip, length;
+
+    do
+    {
+        // Blanks and EOLs are skipped in the window and consumed with the
+        // lexeme.
+        for (skip = 0;;)
+        {
+            if (!calc_LexerPeek(lexer, 1, &window))
+                break;
+
+            // Most of the tokens are separated by a single blank, or none.
+            if (calc_LexerClasses[window.data[0]] > CALC_LEXER_CLASS_EOL)
+                skip = 0;
+            else if ((window.length < 2) || (calc_LexerClasses[window.data[1]] > CALC_LEXER_CLASS_EOL))
+                skip = 1;
+            else
+                skip = bufblanks(window.data, window.length);
+
+            if (skip < window.length)
+                break;
+
+            calcSourceStreamReadBytes(sourceStream, skip, NULL);
+        }
+
+        if (skip >= window.length)
+        {
+            calcSourceStreamBeginLexeme(sourceStream);
+
+            return CALC_TOKEN_TRIVIAL_ENDOF;
+        }
+
+        state = CALC_LEXER_STATE_START;
+        accepted = CALC_LEXER_STATE_DEAD;
+        length = 0;
+        i = skip;
+
+        for (;;)
+        {
+            i = calc_LexerScan(window.data, window.length, i, &state, &accepted, &length);
+
+            // Lexemes can span many refills of open streams, the scan goes on
+            // from the same offset.
+            if ((i < window.length) || (calc_LexerPeek(lexer, i + 1, &window) <= i))
+                break;
+        }
+
+        code = calc_LexerAccept(accepted, skip, i, &length);
+        code = calc_LexerKeyword(code, window.data + skip, length);
+
+        calcSourceStreamReadLexeme(sourceStream, skip, length, outLexeme);
+    } while (code == CALC_TOKEN_TRIVIAL_REMLN);
+
+    return code;
+}
+
+CALC_API CalcTokenCode_t CALC_STDCALL calcLexerNextToken(CalcLexer_t *const lexer, CalcToken_t *const outToken)
+{
+    CalcSourceStream_t *sourceStream = lexer->sourceStream;
+    CalcSourceSpan_t lexeme;
+    CalcTokenCode_t code;
+
+    lexeme.data = NULL;
+    lexeme.length = 0;
+
+    if (!sourceStream->isOpen)
+        code = calc_LexerNextTokenWhole(sourceStream, &lexeme);
+    else
+        code = calc_LexerNextTokenOpen(lexer, &lexeme);
+
+    if (outToken)
+    {
+        outToken->code = code;
+        outToken->lexeme = lexeme;
+        outToken->loc = sourceStream->base + (CalcSourceLoc_t)sourceStream->beginLocation.ch;
+    }
+
+    return code;
+}
+
+CALC_API void CALC_STDCALL calcDeleteLexer(CalcLexer_t *const lexer)
+{
+    free(lexer);
+
+    return;
+}
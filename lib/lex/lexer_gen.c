@@ -0,0 +1,637 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+/* Generator of the tables of the lexer: it builds an NFA from the tokens
+ * defined in tokens.inc but the keywords (and from the patterns of the literal
+ * classes), turns it into a DFA over classes of equivalent bytes and writes
+ * the tables in the file specified by the first argument. It runs at build
+ * time, each time that tokens.inc changes.
+ */
+
+#include "calc/lex/tokens.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CALC_LEXER_GEN_MAX_NFA_STATES
+/// @brief The maximum number of states of the NFA.
+#   define CALC_LEXER_GEN_MAX_NFA_STATES 2048
+#endif // CALC_LEXER_GEN_MAX_NFA_STATES
+
+#ifndef CALC_LEXER_GEN_MAX_NFA_EDGES
+/// @brief The maximum number of edges of the NFA.
+#   define CALC_LEXER_GEN_MAX_NFA_EDGES 4096
+#endif // CALC_LEXER_GEN_MAX_NFA_EDGES
+
+#ifndef CALC_LEXER_GEN_MAX_DFA_STATES
+/// @brief The maximum number of states of the DFA.
+#   define CALC_LEXER_GEN_MAX_DFA_STATES 2048
+#endif // CALC_LEXER_GEN_MAX_DFA_STATES
+
+/// @brief The size (in bytes) of a set of NFA states.
+#define CALC_LEXER_GEN_SET_SIZE (CALC_LEXER_GEN_MAX_NFA_STATES / 8)
+
+/// @brief Priorities of the rules, when a lexeme matches more rules the one
+///        with the lowest priority wins.
+typedef enum _CalcLexerRule
+{
+    CALC_LEXER_RULE_DIRECTIVE = 0,
+    CALC_LEXER_RULE_PUNCTOR,
+    CALC_LEXER_RULE_LITERAL,
+    CALC_LEXER_RULE_COMMENT,
+    CALC_LEXER_RULE_IDENTIFIER,
+    CALC_LEXER_RULE_NONE,
+} CalcLexerRule_t;
+
+/// @brief A token with a fixed lexeme, as defined in tokens.inc. Keywords are
+///        scanned as identifiers, the lexer finds them in the perfect hash
+///        generated by calc-keywords-gen.
+typedef struct _CalcLexerLexeme
+{
+    CalcTokenCode_t code;
+    const char     *lexeme;
+    CalcLexerRule_t rule;
+} CalcLexerLexeme_t;
+
+static const CalcLexerLexeme_t calc_LexerLexemes[] = {
+#define calcDefineToken(name)
+#define calcDefineTokenWithLexeme(name, lexeme)
+#define calcDefineKeywordToken(name, lexeme)
+#define calcDefineDirectiveToken(name, lexeme)        { name, lexeme, CALC_LEXER_RULE_DIRECTIVE },
+#define calcDefinePunctorToken(name, lexeme)          { name, lexeme, CALC_LEXER_RULE_PUNCTOR },
+
+#include CALC_LEX_TOKENS_INC_
+
+#undef calcDefineToken
+};
+
+/// @brief A set of bytes.
+typedef struct _CalcLexerSet
+{
+    unsigned char bits[32];
+} CalcLexerSet_t;
+
+/// @brief An edge of the NFA, it's an epsilon edge when isEpsilon is set.
+typedef struct _CalcLexerEdge
+{
+    int            from;
+    int            to;
+    int            isEpsilon;
+    CalcLexerSet_t set;
+} CalcLexerEdge_t;
+
+static CalcLexerEdge_t calc_Edges[CALC_LEXER_GEN_MAX_NFA_EDGES];
+static int             calc_EdgeCount;
+
+static int             calc_NfaCount;
+static int             calc_NfaAccepts[CALC_LEXER_GEN_MAX_NFA_STATES];
+static int             calc_NfaRules[CALC_LEXER_GEN_MAX_NFA_STATES];
+
+static int             calc_Classes[256];
+static int             calc_ClassCount;
+static int             calc_ClassBytes[256];
+
+static unsigned char   calc_DfaSets[CALC_LEXER_GEN_MAX_DFA_STATES][CALC_LEXER_GEN_SET_SIZE];
+static int             calc_DfaCount;
+static int             calc_DfaAccepts[CALC_LEXER_GEN_MAX_DFA_STATES];
+static int             calc_DfaRules[CALC_LEXER_GEN_MAX_DFA_STATES];
+static int            *calc_DfaTransitions;
+
+/// @brief The NFA states that loop over the bytes of identifiers and of line
+///        comments, the lexer skips their runs with the kernels of scan.h.
+static int             calc_IdentState;
+static int             calc_LineCommentState;
+
+static void calc_Fail(const char *const message)
+{
+    fprintf(stderr, "calc-lexer-gen: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/* =---- Sets of bytes -----------------------------------------= */
+
+static CalcLexerSet_t calc_SetRange(int lo, int hi)
+{
+    CalcLexerSet_t set;
+    int c;
+
+    memset(&set, 0, sizeof(set));
+
+    for (c = lo; c <= hi; c++)
+        set.bits[c >> 3] |= (unsigned char)(1 << (c & 7));
+
+    return set;
+}
+
+static CalcLexerSet_t calc_SetChars(const char *chars)
+{
+    CalcLexerSet_t set;
+
+    memset(&set, 0, sizeof(set));
+
+    for (; *chars; chars++)
+        set.bits[(unsigned char)*chars >> 3] |= (unsigned char)(1 << ((unsigned char)*chars & 7));
+
+    return set;
+}
+
+static CalcLexerSet_t calc_SetUnion(CalcLexerSet_t a, CalcLexerSet_t b)
+{
+    int i;
+
+    for (i = 0; i < 32; i++)
+        a.bits[i] |= b.bits[i];
+
+    return a;
+}
+
+static CalcLexerSet_t calc_SetInvert(CalcLexerSet_t set)
+{
+    int i;
+
+    for (i = 0; i < 32; i++)
+        set.bits[i] = (unsigned char)~set.bits[i];
+
+    return set;
+}
+
+static int calc_SetHas(const CalcLexerSet_t *const set, int c)
+{
+    return (set->bits[c >> 3] >> (c & 7)) & 1;
+}
+
+/* =---- NFA construction --------------------------------------= */
+
+static int calc_NewState(void)
+{
+    if (calc_NfaCount >= CALC_LEXER_GEN_MAX_NFA_STATES)
+        calc_Fail("too many NFA states");
+
+    calc_NfaAccepts[calc_NfaCount] = CALC_TOKEN_INVALID;
+    calc_NfaRules[calc_NfaCount] = CALC_LEXER_RULE_NONE;
+
+    return calc_NfaCount++;
+}
+
+static void calc_Accept(int state, CalcTokenCode_t code, CalcLexerRule_t rule)
+{
+    calc_NfaAccepts[state] = code;
+    calc_NfaRules[state] = rule;
+}
+
+static void calc_AddEdge(int from, int to, CalcLexerSet_t set)
+{
+    if (calc_EdgeCount >= CALC_LEXER_GEN_MAX_NFA_EDGES)
+        calc_Fail("too many NFA edges");
+
+    calc_Edges[calc_EdgeCount].from = from;
+    calc_Edges[calc_EdgeCount].to = to;
+    calc_Edges[calc_EdgeCount].isEpsilon = 0;
+    calc_Edges[calc_EdgeCount].set = set;
+
+    calc_EdgeCount++;
+}
+
+static void calc_AddEpsilon(int from, int to)
+{
+    calc_AddEdge(from, to, calc_SetRange(1, 0));
+    calc_Edges[calc_EdgeCount - 1].isEpsilon = 1;
+}
+
+/// @brief Adds the edges from a state through a set, returning the new state.
+static int calc_Then(int from, CalcLexerSet_t set)
+{
+    int to = calc_NewState();
+
+    calc_AddEdge(from, to, set);
+
+    return to;
+}
+
+/// @brief Adds the edges that match one or more bytes of a set.
+static int calc_ThenMany(int from, CalcLexerSet_t set)
+{
+    int to = calc_Then(from, set);
+
+    calc_AddEdge(to, to, set);
+
+    return to;
+}
+
+/// @brief Adds the edges that match a sequence of bytes.
+static int calc_ThenString(int from, const char *string)
+{
+    char chars[2] = { 0, 0 };
+
+    for (; *string; string++)
+    {
+        chars[0] = *string;
+        from = calc_Then(from, calc_SetChars(chars));
+    }
+
+    return from;
+}
+
+/// @brief Adds the edges that match from lo to hi bytes of a set, accepting
+///        each of them.
+static void calc_ThenRepeat(int from, CalcLexerSet_t set, int lo, int hi, int closing, CalcTokenCode_t code)
+{
+    int i;
+
+    for (i = 1; i <= hi; i++)
+    {
+        from = calc_Then(from, set);
+
+        if (i >= lo)
+            calc_Accept(calc_Then(from, calc_SetRange(closing, closing)), code, CALC_LEXER_RULE_LITERAL);
+    }
+}
+
+/// @brief Adds the numbers of a base: integers and floating points, with the
+///        specified prefix (or without a prefix when it's NULL).
+static void calc_AddNumbers(int start, const char *prefix, CalcLexerSet_t digits, CalcTokenCode_t integer, CalcTokenCode_t floating)
+{
+    int from = start, state;
+
+    if (prefix)
+        from = calc_Then(calc_Then(start, calc_SetChars("0")), calc_SetChars(prefix));
+
+    state = calc_ThenMany(from, digits);
+    calc_Accept(state, integer, CALC_LEXER_RULE_LITERAL);
+
+    // The integral part of floating points is optional.
+    calc_AddEpsilon(from, state = calc_NewState());
+    calc_AddEdge(state, state, digits);
+
+    calc_Accept(calc_ThenMany(calc_Then(state, calc_SetChars(".")), digits), floating, CALC_LEXER_RULE_LITERAL);
+}
+
+static void calc_BuildNfa(int start)
+{
+    CalcLexerSet_t identifierHead = calc_SetUnion(calc_SetUnion(calc_SetRange('a', 'z'), calc_SetRange('A', 'Z')), calc_SetUnion(calc_SetChars("_"), calc_SetRange(0x80, 0xFF)));
+    CalcLexerSet_t identifierTail = calc_SetUnion(identifierHead, calc_SetRange('0', '9'));
+    CalcLexerSet_t hexDigits = calc_SetUnion(calc_SetRange('0', '9'), calc_SetUnion(calc_SetRange('a', 'f'), calc_SetRange('A', 'F')));
+    CalcLexerSet_t nonAscii = calc_SetRange(0x80, 0xFF);
+    int state, escape, body, star;
+    size_t i;
+
+    // Directives and punctuators.
+    for (i = 0; i < (sizeof(calc_LexerLexemes) / sizeof(*calc_LexerLexemes)); i++)
+    {
+        state = start;
+
+        if (calc_LexerLexemes[i].rule == CALC_LEXER_RULE_DIRECTIVE)
+            state = calc_ThenString(state, "#");
+
+        calc_Accept(calc_ThenString(state, calc_LexerLexemes[i].lexeme), calc_LexerLexemes[i].code, calc_LexerLexemes[i].rule);
+    }
+
+    // Identifiers, and the names of unknown directives that are invalid
+    // tokens (otherwise a directive would match the prefix of a name).
+    state = calc_Then(start, identifierHead);
+
+    calc_AddEdge(state, state, identifierTail);
+    calc_Accept(state, CALC_TOKEN_IDENT, CALC_LEXER_RULE_IDENTIFIER);
+
+    calc_IdentState = state;
+
+    state = calc_Then(calc_ThenString(start, "#"), identifierHead);
+
+    calc_AddEdge(state, state, identifierTail);
+    calc_Accept(state, CALC_TOKEN_INVALID, CALC_LEXER_RULE_IDENTIFIER);
+
+    // Numbers.
+    calc_AddNumbers(start, NULL, calc_SetRange('0', '9'), CALC_TOKEN_LITERAL_INTEGER_DEC, CALC_TOKEN_LITERAL_FLOAT_DEC);
+    calc_AddNumbers(start, "Dd", calc_SetRange('0', '9'), CALC_TOKEN_LITERAL_INTEGER_DEC, CALC_TOKEN_LITERAL_FLOAT_DEC);
+    calc_AddNumbers(start, "Bb", calc_SetRange('0', '1'), CALC_TOKEN_LITERAL_INTEGER_BIN, CALC_TOKEN_LITERAL_FLOAT_BIN);
+    calc_AddNumbers(start, "Cc", calc_SetRange('0', '7'), CALC_TOKEN_LITERAL_INTEGER_OCT, CALC_TOKEN_LITERAL_FLOAT_OCT);
+    calc_AddNumbers(start, "Xx", hexDigits, CALC_TOKEN_LITERAL_INTEGER_HEX, CALC_TOKEN_LITERAL_FLOAT_HEX);
+
+    // Characters: a single ASCII character, a sequence of non-ASCII bytes (an
+    // UTF-8 character) or an escape sequence.
+    state = calc_Then(start, calc_SetChars("'"));
+
+    calc_Accept(calc_ThenString(calc_Then(state, calc_SetInvert(calc_SetUnion(calc_SetChars("'\\\n"), nonAscii))), "'"), CALC_TOKEN_LITERAL_CHAR, CALC_LEXER_RULE_LITERAL);
+    calc_Accept(calc_ThenString(calc_ThenMany(state, nonAscii), "'"), CALC_TOKEN_LITERAL_CHAR, CALC_LEXER_RULE_LITERAL);
+
+    escape = calc_ThenString(state, "\\");
+
+    calc_Accept(calc_ThenString(calc_Then(escape, calc_SetChars("abefnrstv\\?'\"")), "'"), CALC_TOKEN_LITERAL_CHAR_ESC, CALC_LEXER_RULE_LITERAL);
+    calc_ThenRepeat(escape, calc_SetRange('0', '7'), 1, 3, '\'', CALC_TOKEN_LITERAL_CHAR_OCT);
+    calc_ThenRepeat(calc_Then(escape, calc_SetChars("Xx")), hexDigits, 1, 4, '\'', CALC_TOKEN_LITERAL_CHAR_HEX);
+    calc_ThenRepeat(calc_Then(escape, calc_SetChars("Uu")), hexDigits, 1, 6, '\'', CALC_TOKEN_LITERAL_CHAR_UNI);
+
+    // Strings, they can't span more lines.
+    body = calc_Then(start, calc_SetChars("\""));
+
+    calc_AddEdge(body, body, calc_SetInvert(calc_SetChars("\"\\\n")));
+    calc_AddEdge(calc_ThenString(body, "\\"), body, calc_SetInvert(calc_SetChars("\n")));
+    calc_Accept(calc_ThenString(body, "\""), CALC_TOKEN_LITERAL_STRING, CALC_LEXER_RULE_LITERAL);
+
+    // Comments, they are removed from the tokens.
+    state = calc_ThenString(start, "//");
+
+    calc_AddEdge(state, state, calc_SetInvert(calc_SetChars("\n")));
+    calc_Accept(state, CALC_TOKEN_TRIVIAL_REMLN, CALC_LEXER_RULE_COMMENT);
+
+    calc_LineCommentState = state;
+
+    body = calc_ThenString(start, "/*");
+    star = calc_NewState();
+
+    calc_AddEdge(body, body, calc_SetInvert(calc_SetChars("*")));
+    calc_AddEdge(body, star, calc_SetChars("*"));
+    calc_AddEdge(star, star, calc_SetChars("*"));
+    calc_AddEdge(star, body, calc_SetInvert(calc_SetChars("*/")));
+    calc_Accept(calc_ThenString(star, "/"), CALC_TOKEN_TRIVIAL_REMLN, CALC_LEXER_RULE_COMMENT);
+}
+
+/* =---- Byte classes ------------------------------------------= */
+
+/// @brief Splits the bytes in classes of bytes that are never distinguished
+///        by the edges. Blanks and EOLs are split from the others (and they
+///        are the first two classes), so the lexer skips them by class.
+static void calc_BuildClasses(void)
+{
+    int keys[256], map[512], next, c, e, i, order[256];
+    CalcLexerSet_t blanks = calc_SetChars(" \t\v\f\r"), eols = calc_SetChars("\n");
+
+    memset(calc_Classes, 0, sizeof(calc_Classes));
+    calc_ClassCount = 1;
+
+    for (e = -2; e < calc_EdgeCount; e++)
+    {
+        const CalcLexerSet_t *set = (e == -2) ? &blanks : (e == -1) ? &eols : &calc_Edges[e].set;
+
+        if ((e >= 0) && calc_Edges[e].isEpsilon)
+            continue;
+
+        for (i = 0; i < 512; i++)
+            map[i] = -1;
+
+        for (c = 0, next = 0; c < 256; c++)
+        {
+            keys[c] = (calc_Classes[c] << 1) | calc_SetHas(set, c);
+
+            if (map[keys[c]] < 0)
+                map[keys[c]] = next++;
+
+            calc_Classes[c] = map[keys[c]];
+        }
+
+        calc_ClassCount = next;
+    }
+
+    // Renumbers the classes: blanks first, then EOLs, then the others in
+    // order of their first byte.
+    for (i = 0; i < 256; i++)
+        order[i] = -1;
+
+    next = 0;
+    order[calc_Classes[' ']] = next++;
+    order[calc_Classes['\n']] = next++;
+
+    for (c = 0; c < 256; c++)
+    {
+        if (order[calc_Classes[c]] < 0)
+            order[calc_Classes[c]] = next++;
+    }
+
+    for (c = 0; c < 256; c++)
+        calc_Classes[c] = order[calc_Classes[c]];
+
+    for (c = 255; c >= 0; c--)
+        calc_ClassBytes[calc_Classes[c]] = c;
+}
+
+/* =---- DFA construction --------------------------------------= */
+
+static void calc_Closure(unsigned char *const set)
+{
+    int e, changed = 1;
+
+    while (changed)
+    {
+        changed = 0;
+
+        for (e = 0; e < calc_EdgeCount; e++)
+        {
+            if (calc_Edges[e].isEpsilon && (set[calc_Edges[e].from >> 3] & (1 << (calc_Edges[e].from & 7))) && !(set[calc_Edges[e].to >> 3] & (1 << (calc_Edges[e].to & 7))))
+            {
+                set[calc_Edges[e].to >> 3] |= (unsigned char)(1 << (calc_Edges[e].to & 7));
+                changed = 1;
+            }
+        }
+    }
+}
+
+static int calc_FindDfaState(const unsigned char *const set)
+{
+    int i;
+
+    for (i = 0; i < calc_DfaCount; i++)
+    {
+        if (!memcmp(calc_DfaSets[i], set, CALC_LEXER_GEN_SET_SIZE))
+            return i;
+    }
+
+    if (calc_DfaCount >= CALC_LEXER_GEN_MAX_DFA_STATES)
+        calc_Fail("too many DFA states");
+
+    memcpy(calc_DfaSets[calc_DfaCount], set, CALC_LEXER_GEN_SET_SIZE);
+
+    return calc_DfaCount++;
+}
+
+static void calc_BuildDfa(int start)
+{
+    unsigned char set[CALC_LEXER_GEN_SET_SIZE];
+    int state, c, e, s;
+
+    calc_DfaTransitions = (int *)malloc(sizeof(int) * CALC_LEXER_GEN_MAX_DFA_STATES * 256);
+
+    // The dead state is the empty set.
+    memset(set, 0, sizeof(set));
+    calc_FindDfaState(set);
+
+    set[start >> 3] |= (unsigned char)(1 << (start & 7));
+    calc_Closure(set);
+    calc_FindDfaState(set);
+
+    for (state = 0; state < calc_DfaCount; state++)
+    {
+        for (c = 0; c < calc_ClassCount; c++)
+        {
+            memset(set, 0, sizeof(set));
+
+            for (e = 0; e < calc_EdgeCount; e++)
+            {
+                s = calc_Edges[e].from;
+
+                if (!calc_Edges[e].isEpsilon && (calc_DfaSets[state][s >> 3] & (1 << (s & 7))) && calc_SetHas(&calc_Edges[e].set, calc_ClassBytes[c]))
+                    set[calc_Edges[e].to >> 3] |= (unsigned char)(1 << (calc_Edges[e].to & 7));
+            }
+
+            calc_Closure(set);
+            calc_DfaTransitions[(state * 256) + c] = calc_FindDfaState(set);
+        }
+
+        calc_DfaAccepts[state] = CALC_TOKEN_INVALID;
+        calc_DfaRules[state] = CALC_LEXER_RULE_NONE;
+
+        for (s = 0; s < calc_NfaCount; s++)
+        {
+            if ((calc_DfaSets[state][s >> 3] & (1 << (s & 7))) && (calc_NfaRules[s] < calc_DfaRules[state]))
+            {
+                calc_DfaAccepts[state] = calc_NfaAccepts[s];
+                calc_DfaRules[state] = calc_NfaRules[s];
+            }
+        }
+    }
+}
+
+/* =---- Output ------------------------------------------------= */
+
+/// @brief Finds the DFA state made only of the specified NFA state.
+/// @return The DFA state, or the dead state if there's none.
+static int calc_FindLoopState(int nfaState)
+{
+    unsigned char set[CALC_LEXER_GEN_SET_SIZE];
+    int i;
+
+    memset(set, 0, sizeof(set));
+    set[nfaState >> 3] |= (unsigned char)(1 << (nfaState & 7));
+
+    for (i = 0; i < calc_DfaCount; i++)
+    {
+        if (!memcmp(calc_DfaSets[i], set, CALC_LEXER_GEN_SET_SIZE))
+            return i;
+    }
+
+    return 0;
+}
+
+static void calc_WriteTables(FILE *const stream)
+{
+    int *order = (int *)malloc(sizeof(int) * calc_DfaCount), *states = (int *)malloc(sizeof(int) * calc_DfaCount);
+    int i, c, next = 0, firstAccepting, isWide;
+
+    // The dead state is the first, then the start state and the states that
+    // are not accepting, so accepting states are found by a comparison.
+    order[0] = next++;
+    order[1] = next++;
+
+    for (i = 2; i < calc_DfaCount; i++)
+    {
+        if (calc_DfaRules[i] == CALC_LEXER_RULE_NONE)
+            order[i] = next++;
+    }
+
+    firstAccepting = next;
+
+    for (i = 2; i < calc_DfaCount; i++)
+    {
+        if (calc_DfaRules[i] != CALC_LEXER_RULE_NONE)
+            order[i] = next++;
+    }
+
+    for (i = 0; i < calc_DfaCount; i++)
+        states[order[i]] = i;
+
+    isWide = ((calc_DfaCount * calc_ClassCount) > 0xFFFF);
+
+    fprintf(stream, "/**                                                                     -*- C -*-\n");
+    fprintf(stream, " * @file        lexer_tables.inc\n");
+    fprintf(stream, " *\n");
+    fprintf(stream, " * @brief       This file is generated by calc-lexer-gen from tokens.inc, do not\n");
+    fprintf(stream, " *              edit it. It defines the tables of the DFA of the lexer: %d\n", calc_DfaCount);
+    fprintf(stream, " *              states over %d classes of bytes.\n", calc_ClassCount);
+    fprintf(stream, " */\n\n");
+
+    fprintf(stream, "#ifndef CALC_LEX_LEXER_TABLES_INC_\n#define CALC_LEX_LEXER_TABLES_INC_\n\n");
+
+    fprintf(stream, "/// @brief The number of classes of bytes.\n");
+    fprintf(stream, "#define CALC_LEXER_CLASS_COUNT %d\n", calc_ClassCount);
+    fprintf(stream, "/// @brief The number of states.\n");
+    fprintf(stream, "#define CALC_LEXER_STATE_COUNT %d\n\n", calc_DfaCount);
+    fprintf(stream, "/// @brief The class of blanks, the one of EOLs is next to it.\n");
+    fprintf(stream, "#define CALC_LEXER_CLASS_BLANK 0\n");
+    fprintf(stream, "/// @brief The class of EOLs.\n");
+    fprintf(stream, "#define CALC_LEXER_CLASS_EOL 1\n\n");
+    fprintf(stream, "/// @brief The dead state, states are premultiplied by the number of classes.\n");
+    fprintf(stream, "#define CALC_LEXER_STATE_DEAD 0\n");
+    fprintf(stream, "/// @brief The start state.\n");
+    fprintf(stream, "#define CALC_LEXER_STATE_START %d\n", calc_ClassCount);
+    fprintf(stream, "/// @brief The first accepting state, all the following ones are accepting.\n");
+    fprintf(stream, "#define CALC_LEXER_STATE_ACCEPTING %d\n", firstAccepting * calc_ClassCount);
+    fprintf(stream, "/// @brief The state inside an identifier, that isn't a keyword prefix.\n");
+    fprintf(stream, "#define CALC_LEXER_STATE_IDENT %d\n", order[calc_FindLoopState(calc_IdentState)] * calc_ClassCount);
+    fprintf(stream, "/// @brief The state inside a line comment.\n");
+    fprintf(stream, "#define CALC_LEXER_STATE_LINE_COMMENT %d\n\n", order[calc_FindLoopState(calc_LineCommentState)] * calc_ClassCount);
+
+    fprintf(stream, "/// @brief The type of the states.\n");
+    fprintf(stream, "typedef %s calc_LexerState_t;\n\n", isWide ? "uint32_t" : "uint16_t");
+
+    fprintf(stream, "/// @brief The class of each byte.\n");
+    fprintf(stream, "static const byte_t calc_LexerClasses[256] = {");
+
+    for (c = 0; c < 256; c++)
+        fprintf(stream, "%s%2d,", (c % 16) ? " " : "\n    ", calc_Classes[c]);
+
+    fprintf(stream, "\n};\n\n");
+
+    fprintf(stream, "/// @brief The transitions, indexed by a state plus the class of a byte.\n");
+    fprintf(stream, "static const calc_LexerState_t calc_LexerTransitions[CALC_LEXER_STATE_COUNT * CALC_LEXER_CLASS_COUNT] = {\n");
+
+    for (i = 0; i < calc_DfaCount; i++)
+    {
+        fprintf(stream, "   ");
+
+        for (c = 0; c < calc_ClassCount; c++)
+            fprintf(stream, " %d,", order[calc_DfaTransitions[(states[i] * 256) + c]] * calc_ClassCount);
+
+        fprintf(stream, "\n");
+    }
+
+    fprintf(stream, "};\n\n");
+
+    fprintf(stream, "/// @brief The token code accepted by each state (not premultiplied).\n");
+    fprintf(stream, "static const uint16_t calc_LexerAccepts[CALC_LEXER_STATE_COUNT] = {");
+
+    for (i = 0; i < calc_DfaCount; i++)
+        fprintf(stream, "%s%3d,", (i % 16) ? " " : "\n    ", calc_DfaAccepts[states[i]]);
+
+    fprintf(stream, "\n};\n\n#endif // CALC_LEX_LEXER_TABLES_INC_\n");
+
+    free(states);
+    free(order);
+}
+
+int main(int argc, char **argv)
+{
+    FILE *stream;
+    int start;
+
+    if (argc < 2)
+        calc_Fail("usage: calc-lexer-gen <output>");
+
+    start = calc_NewState();
+
+    calc_BuildNfa(start);
+    calc_BuildClasses();
+    calc_BuildDfa(start);
+
+    if (!(stream = fopen(argv[1], "w")))
+        calc_Fail("cannot open the output file");
+
+    calc_WriteTables(stream);
+    fclose(stream);
+
+    free(calc_DfaTransitions);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,433 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/file.h"
+#include "calc/base/scan.h"
+#include "calc/base/string.h"
+#include "calc/base/thread.h"
+
+#include "calc/lex/token_buffer.h"
+
+/// @brief The size (in bytes) of the data of a token, in all the arrays.
+#define CALC_TOKEN_BUFFER_TOKEN_SIZE (sizeof(CalcTokenCode_t) + sizeof(uint32_t) + sizeof(uint32_t))
+
+/// @brief Points the arrays of a token buffer into its block, one after the
+///        other.
+static inline void CALC_STDCALL calc_TokenBufferLayout(CalcTokenBuffer_t *const tokenBuffer, void *const block)
+{
+    tokenBuffer->codes = (CalcTokenCode_t *)block;
+    tokenBuffer->offsets = (uint32_t *)(tokenBuffer->codes + tokenBuffer->capacity);
+    tokenBuffer->lengths = tokenBuffer->offsets + tokenBuffer->capacity;
+
+    return;
+}
+
+CALC_API CalcTokenBuffer_t *CALC_STDCALL calcCreateTokenBuffer(const CalcSourceBuffer_t *const sourceBuffer, size_t capacity)
+{
+    assert(sourceBuffer != NULL);
+
+    CalcTokenBuffer_t *tokenBuffer = alloc(CalcTokenBuffer_t);
+
+    tokenBuffer->sourceBuffer = sourceBuffer;
+    tokenBuffer->count = 0;
+    tokenBuffer->capacity = capacity ? capacity : CALC_TOKEN_BUFFER_CAPACITY;
+
+    calc_TokenBufferLayout(tokenBuffer, cmalloc(tokenBuffer->capacity * CALC_TOKEN_BUFFER_TOKEN_SIZE));
+
+    return tokenBuffer;
+}
+
+/// @brief Doubles the capacity of a token buffer. The block is reallocated
+///        and the arrays are moved to their new places, from the last one.
+static void CALC_STDCALL calc_TokenBufferGrow(CalcTokenBuffer_t *const tokenBuffer)
+{
+    size_t count = tokenBuffer->count;
+    void *block = crealloc(tokenBuffer->codes, (tokenBuffer->capacity << 1) * CALC_TOKEN_BUFFER_TOKEN_SIZE);
+    uint32_t *offsets = (uint32_t *)((CalcTokenCode_t *)block + tokenBuffer->capacity);
+    uint32_t *lengths = offsets + tokenBuffer->capacity;
+
+    tokenBuffer->capacity <<= 1;
+    calc_TokenBufferLayout(tokenBuffer, block);
+
+    memmove(tokenBuffer->lengths, lengths, count * sizeof(uint32_t));
+    memmove(tokenBuffer->offsets, offsets, count * sizeof(uint32_t));
+
+    return;
+}
+
+CALC_API void CALC_STDCALL calcTokenBufferPush(CalcTokenBuffer_t *const tokenBuffer, CalcTokenCode_t code, uint32_t offset, uint32_t length)
+{
+    if (tokenBuffer->count == tokenBuffer->capacity)
+        calc_TokenBufferGrow(tokenBuffer);
+
+    tokenBuffer->codes[tokenBuffer->count] = code;
+    tokenBuffer->offsets[tokenBuffer->count] = offset;
+    tokenBuffer->lengths[tokenBuffer->count] = length;
+    tokenBuffer->count++;
+
+    return;
+}
+
+CALC_API size_t CALC_STDCALL calcTokenBufferScan(CalcTokenBuffer_t *const tokenBuffer, CalcLexer_t *const lexer)
+{
+    const CalcSourceStream_t *sourceStream = lexer->sourceStream;
+    const byte_t *data = tokenBuffer->sourceBuffer->data;
+    size_t count = tokenBuffer->count, offset;
+    CalcToken_t token;
+
+    // Lexemes of open streams are in a ring, they can't be referenced.
+    if (sourceStream->isOpen || (sourceStream->buffer != tokenBuffer->sourceBuffer))
+        return 0;
+
+    do
+    {
+        calcLexerNextToken(lexer, &token);
+
+        offset = token.lexeme.data ? (size_t)(token.lexeme.data - data) : (size_t)(token.loc - sourceStream->base);
+
+        // The tokens alredy pushed by this scan are dropped.
+        if ((offset > CALC_TOKEN_BUFFER_MAX_OFFSET) || (token.lexeme.length > (CALC_TOKEN_BUFFER_MAX_OFFSET - offset)))
+        {
+            tokenBuffer->count = count;
+
+            return 0;
+        }
+
+        calcTokenBufferPush(tokenBuffer, token.code, (uint32_t)offset, (uint32_t)token.lexeme.length);
+    } while (token.code != CALC_TOKEN_TRIVIAL_ENDOF);
+
+    return tokenBuffer->count - count;
+}
+
+/// @brief The offset of the end of the comment of chunks without '*/'.
+#define CALC_TOKEN_CHUNK_NO_COMMENT ((size_t)-1)
+
+/// @brief A chunk of a parallel scan, with the tokens lexed under each state
+///        in which it can begin.
+typedef struct _CalcTokenChunk
+{
+    /// @brief The offset of the first byte of the chunk.
+    size_t             begin;
+    /// @brief The offset next to the last byte of the chunk (an EOL).
+    size_t             end;
+    /// @brief The tokens of the chunk when it begins out of tokens.
+    CalcTokenBuffer_t *tokens;
+    /// @brief The offset next to the last token lexed from the beginning.
+    size_t             resume;
+    /// @brief The tokens of the chunk when it begins inside a block comment,
+    ///        lexed from the end of the comment.
+    CalcTokenBuffer_t *commentTokens;
+    /// @brief The offset next to the first '*/' of the chunk, or
+    ///        CALC_TOKEN_CHUNK_NO_COMMENT if the chunk has none.
+    size_t             commentEnd;
+    /// @brief The offset next to the last token lexed from the end of the
+    ///        comment.
+    size_t             commentResume;
+    /// @brief The offset next to the first '*/' of the following chunks, or
+    ///        CALC_TOKEN_CHUNK_NO_COMMENT if they have none.
+    size_t             nextCommentEnd;
+    /// @brief When it's set to TRUE a lexeme of the chunk is out of the
+    ///        32-bit offsets.
+    bool_t             isOverflowed;
+} CalcTokenChunk_t;
+
+/// @brief The state shared by the threads of a parallel scan.
+typedef struct _CalcTokenScan
+{
+    const byte_t     *data;
+    size_t            size;
+    CalcTokenChunk_t *chunks;
+    size_t            count;
+    size_t            next;
+    handle_t          mutex;
+} CalcTokenScan_t;
+
+/// @brief Finds the offset next to the first '*/' between two offsets.
+/// @return The found offset, or CALC_TOKEN_CHUNK_NO_COMMENT if there's
+///         none.
+static size_t CALC_STDCALL calc_TokenBufferFindCommentEnd(const byte_t *const data, size_t begin, size_t end)
+{
+    size_t position = begin;
+
+    while ((position += bufuntil(data + position, end - position, '*')) < end)
+    {
+        if (((position + 1) < end) && (data[position + 1] == '/'))
+            return position + 2;
+
+        position++;
+    }
+
+    return CALC_TOKEN_CHUNK_NO_COMMENT;
+}
+
+/// @brief Lexes the tokens that begin from the specified offset up to the end
+///        of a chunk into a token buffer, comments excluded. Lexemes can go on
+///        after the end of the chunk, up to the end of the source.
+/// @return The offset next to the last lexed token (comments included), or
+///         the specified offset if there are no tokens.
+static size_t CALC_STDCALL calc_TokenBufferLexChunk(CalcTokenScan_t *const tokenScan, CalcTokenChunk_t *const chunk, size_t position, CalcTokenBuffer_t *const tokenBuffer)
+{
+    const byte_t *data = tokenScan->data;
+    size_t size = tokenScan->size, end = chunk->end, resume = position, length, limit = 0, window;
+    CalcTokenCode_t code;
+
+    for (;;)
+    {
+        if ((position += bufblanks(data + position, size - position)) >= end)
+            break;
+
+        window = size - position;
+
+        // A block comment ends at the first '*/' after its '/*', otherwise
+        // it's a '/'. The '*/' is searched once for all the comments that
+        // precede it, so the DFA never scans an unterminated comment up to
+        // the end of the source.
+        if ((data[position] == '/') && ((position + 1) < size) && (data[position + 1] == '*'))
+        {
+            if (limit < (position + 4))
+            {
+                if ((limit = calc_TokenBufferFindCommentEnd(data, position + 2, end)) == CALC_TOKEN_CHUNK_NO_COMMENT)
+                    limit = chunk->nextCommentEnd;
+            }
+
+            window = (limit != CALC_TOKEN_CHUNK_NO_COMMENT) ? (limit - position) : 1;
+        }
+
+        code = calcLexerMatch(data + position, window, &length);
+
+        if ((position > CALC_TOKEN_BUFFER_MAX_OFFSET) || (length > (CALC_TOKEN_BUFFER_MAX_OFFSET - position)))
+            return chunk->isOverflowed = TRUE, resume;
+
+        if (code != CALC_TOKEN_TRIVIAL_REMLN)
+            calcTokenBufferPush(tokenBuffer, code, (uint32_t)position, (uint32_t)length);
+
+        resume = position += length;
+    }
+
+    return resume;
+}
+
+/// @brief Claims the next chunk of a parallel scan.
+/// @return The index of the chunk, or the number of chunks when they're all
+///         claimed.
+static inline size_t CALC_STDCALL calc_TokenBufferClaim(CalcTokenScan_t *const tokenScan)
+{
+    size_t i;
+
+    mtxlock(tokenScan->mutex);
+    i = tokenScan->next++;
+    mtxunlock(tokenScan->mutex);
+
+    return min(i, tokenScan->count);
+}
+
+static void CALC_STDCALL calc_TokenBufferFindRun(void *arg)
+{
+    CalcTokenScan_t *tokenScan = (CalcTokenScan_t *)arg;
+    CalcTokenChunk_t *chunk;
+    size_t i;
+
+    while ((i = calc_TokenBufferClaim(tokenScan)) < tokenScan->count)
+    {
+        chunk = &tokenScan->chunks[i];
+        chunk->commentEnd = calc_TokenBufferFindCommentEnd(tokenScan->data, chunk->begin, chunk->end);
+    }
+
+    return;
+}
+
+static void CALC_STDCALL calc_TokenBufferLexRun(void *arg)
+{
+    CalcTokenScan_t *tokenScan = (CalcTokenScan_t *)arg;
+    CalcTokenChunk_t *chunk;
+    size_t i;
+
+    while ((i = calc_TokenBufferClaim(tokenScan)) < tokenScan->count)
+    {
+        chunk = &tokenScan->chunks[i];
+        chunk->resume = calc_TokenBufferLexChunk(tokenScan, chunk, chunk->begin, chunk->tokens);
+
+        // The first chunk always begins out of tokens.
+        if (i && (chunk->commentEnd != CALC_TOKEN_CHUNK_NO_COMMENT))
+            chunk->commentResume = calc_TokenBufferLexChunk(tokenScan, chunk, chunk->commentEnd, chunk->commentTokens);
+    }
+
+    return;
+}
+
+/// @brief Runs a function over the chunks of a parallel scan on a pool of
+///        threads, the calling thread is one of them.
+static void CALC_STDCALL calc_TokenBufferRun(CalcTokenScan_t *const tokenScan, thrdfunc_t run, handle_t *const threads, size_t threadCount)
+{
+    size_t i, spawned = 0;
+
+    tokenScan->next = 0;
+
+    for (i = 1; i < threadCount; i++)
+    {
+        if (!(threads[spawned] = thrdspawn(run, (void *)tokenScan)))
+            break;
+
+        spawned++;
+    }
+
+    run((void *)tokenScan);
+
+    for (i = 0; i < spawned; i++)
+        thrdjoin(threads[i]);
+
+    return;
+}
+
+/// @brief Appends all the tokens of a token buffer to another one.
+static void CALC_STDCALL calc_TokenBufferAppend(CalcTokenBuffer_t *const tokenBuffer, const CalcTokenBuffer_t *const other)
+{
+    while ((tokenBuffer->count + other->count) > tokenBuffer->capacity)
+        calc_TokenBufferGrow(tokenBuffer);
+
+    memcpy(tokenBuffer->codes + tokenBuffer->count, other->codes, other->count * sizeof(CalcTokenCode_t));
+    memcpy(tokenBuffer->offsets + tokenBuffer->count, other->offsets, other->count * sizeof(uint32_t));
+    memcpy(tokenBuffer->lengths + tokenBuffer->count, other->lengths, other->count * sizeof(uint32_t));
+
+    tokenBuffer->count += other->count;
+
+    return;
+}
+
+CALC_API size_t CALC_STDCALL calcTokenBufferScanParallel(CalcTokenBuffer_t *const tokenBuffer, size_t chunkSize, size_t threadCount)
+{
+    const CalcSourceBuffer_t *sourceBuffer = tokenBuffer->sourceBuffer;
+    size_t count = tokenBuffer->count, position, end, i;
+    bool_t isOverflowed = FALSE;
+    CalcTokenScan_t tokenScan;
+    CalcTokenChunk_t *chunk;
+    const byte_t *eol;
+    handle_t *threads;
+
+    if (!chunkSize)
+        chunkSize = CALC_TOKEN_BUFFER_CHUNK_SIZE;
+
+    if (!threadCount)
+        threadCount = (size_t)thrdcount();
+
+    tokenScan.data = sourceBuffer->data;
+    tokenScan.size = sourceBuffer->size ? (sourceBuffer->size - 1) : 0;
+    tokenScan.count = 0;
+
+    if (tokenScan.size > CALC_TOKEN_BUFFER_MAX_OFFSET)
+        return 0;
+
+    // Chunks end at the first EOL after their minimum size (or at the end of
+    // the source), so each one begins at the beginning of a line.
+    tokenScan.chunks = dim(CalcTokenChunk_t, (tokenScan.size / chunkSize) + 1);
+
+    for (position = 0; position < tokenScan.size; position = end)
+    {
+        end = min(position + chunkSize, tokenScan.size);
+
+        if ((end < tokenScan.size) && ((eol = (const byte_t *)memchr(tokenScan.data + end - 1, EOL, tokenScan.size - end + 1)) != NULL))
+            end = (size_t)(eol - tokenScan.data) + 1;
+        else
+            end = tokenScan.size;
+
+        chunk = &tokenScan.chunks[tokenScan.count++];
+        chunk->begin = position;
+        chunk->end = end;
+        chunk->tokens = calcCreateTokenBuffer(sourceBuffer, 0);
+        chunk->resume = position;
+        chunk->commentTokens = calcCreateTokenBuffer(sourceBuffer, 0);
+        chunk->commentEnd = CALC_TOKEN_CHUNK_NO_COMMENT;
+        chunk->commentResume = CALC_TOKEN_CHUNK_NO_COMMENT;
+        chunk->nextCommentEnd = CALC_TOKEN_CHUNK_NO_COMMENT;
+        chunk->isOverflowed = FALSE;
+    }
+
+    threadCount = min(threadCount, tokenScan.count);
+    tokenScan.mutex = mtxcreate();
+
+    threads = dim(handle_t, max(threadCount, 1));
+
+    // The '*/' of the chunks are found first, so the comments that go on
+    // after the end of their chunk are bounded too.
+    calc_TokenBufferRun(&tokenScan, calc_TokenBufferFindRun, threads, threadCount);
+
+    for (i = tokenScan.count; i > 1; i--)
+    {
+        chunk = &tokenScan.chunks[i - 1];
+        chunk[-1].nextCommentEnd = (chunk->commentEnd != CALC_TOKEN_CHUNK_NO_COMMENT) ? chunk->commentEnd : chunk->nextCommentEnd;
+    }
+
+    calc_TokenBufferRun(&tokenScan, calc_TokenBufferLexRun, threads, threadCount);
+
+    free(threads);
+    mtxdelete(tokenScan.mutex);
+
+    // Each chunk flags its own overflows, so the threads never share a flag.
+    for (i = 0; i < tokenScan.count; i++)
+        isOverflowed |= tokenScan.chunks[i].isOverflowed;
+
+    // Each chunk begins where the last token of the previous ones ends: out
+    // of tokens when it's before the chunk, or after a block comment (or any
+    // other token that spans lines) when it's inside it.
+    for (i = 0, position = 0; (i < tokenScan.count) && !isOverflowed; i++)
+    {
+        chunk = &tokenScan.chunks[i];
+
+        if (position <= chunk->begin)
+        {
+            calc_TokenBufferAppend(tokenBuffer, chunk->tokens);
+            position = chunk->resume;
+        }
+        else if (position == chunk->commentEnd)
+        {
+            calc_TokenBufferAppend(tokenBuffer, chunk->commentTokens);
+            position = chunk->commentResume;
+        }
+        else if (position < chunk->end)
+        {
+            calcClearTokenBuffer(chunk->tokens);
+            position = calc_TokenBufferLexChunk(&tokenScan, chunk, position, chunk->tokens);
+            calc_TokenBufferAppend(tokenBuffer, chunk->tokens);
+
+            isOverflowed = chunk->isOverflowed;
+        }
+    }
+
+    for (i = 0; i < tokenScan.count; i++)
+    {
+        calcDeleteTokenBuffer(tokenScan.chunks[i].tokens);
+        calcDeleteTokenBuffer(tokenScan.chunks[i].commentTokens);
+    }
+
+    free(tokenScan.chunks);
+
+    if (isOverflowed)
+    {
+        tokenBuffer->count = count;
+
+        return 0;
+    }
+
+    calcTokenBufferPush(tokenBuffer, CALC_TOKEN_TRIVIAL_ENDOF, (uint32_t)tokenScan.size, 0);
+
+    return tokenBuffer->count - count;
+}
+
+CALC_API void CALC_STDCALL calcClearTokenBuffer(CalcTokenBuffer_t *const tokenBuffer)
+{
+    tokenBuffer->count = 0;
+
+    return;
+}
+
+CALC_API void CALC_STDCALL calcDeleteTokenBuffer(CalcTokenBuffer_t *const tokenBuffer)
+{
+    free(tokenBuffer->codes);
+    free(tokenBuffer);
+
+    return;
+}
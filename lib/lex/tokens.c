@@ -1,5 +1,10 @@
+#include "calc/base/bits.h"
+#include "calc/base/string.h"
 #include "calc/lex/tokens.h"
 
+// Generated by calc-keywords-gen from tokens.inc.
+#include "keywords_hash.inc"
+
 CALC_API const char *CALC_STDCALL calcGetTokenLexeme(CalcTokenCode_t token)
 {
     switch (token)
@@ -29,3 +34,18 @@ CALC_API const char *CALC_STDCALL calcGetTokenLexeme(CalcTokenCode_t token)
         return CALC_EMPTY_LEXEME;
     }
 }
+
+CALC_API CalcTokenCode_t CALC_STDCALL calcGetKeywordToken(const char *const data, size_t length)
+{
+    size_t slot;
+
+    if ((length < CALC_KEYWORDS_MIN_LENGTH) || (length > CALC_KEYWORDS_MAX_LENGTH))
+        return CALC_TOKEN_INVALID;
+
+    slot = (length + calc_KeywordValues[(unsigned char)data[0]] + calc_KeywordValues[(unsigned char)data[length - 1]]) & (CALC_KEYWORDS_HASH_SIZE - 1);
+
+    if ((calc_KeywordSlots[slot].length != length) || memcmp(calc_KeywordSlots[slot].lexeme, data, length))
+        return CALC_TOKEN_INVALID;
+
+    return calc_KeywordSlots[slot].code;
+}
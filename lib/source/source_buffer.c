@@ -4,10 +4,29 @@
  * informations.
  */
 
+#include "calc/base/alloc.h"
+#include "calc/base/fmap.h"
 #include "calc/base/string.h"
 #include "calc/base/utf8.h"
 
 #include "calc/source/source_buffer.h"
+#include "calc/source/source_lines.h"
+
+/// @brief Detects the BOM at the beginning of a content.
+/// @param outSkip A pointer to a variable in which store the length of the
+///                BOM, 0 when there's none.
+/// @return The encoding declared by the BOM, or the specified one.
+static inline CalcSourceEncoding_t CALC_STDCALL calc_DetectSourceBom(const byte_t *const data, size_t length, CalcSourceEncoding_t encoding, size_t *const outSkip)
+{
+    *outSkip = 0;
+
+    if ((length >= 3) && (data[0] == 0xEF) && (data[1] == 0xBB) && (data[2] == 0xBF))
+        return *outSkip = 3, CALC_SOURCE_ENCODING_UTF_8;
+    else if ((length >= 2) && (data[0] == 0xFF) && (data[1] == 0xFE))
+        return *outSkip = 2, CALC_SOURCE_ENCODING_UTF_16LE;
+    else
+        return encoding;
+}
 
 CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBuffer(size_t size, byte_t *const content, size_t count)
 {
@@ -19,6 +38,12 @@ CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBuffer(size_t size, by
         sourceBuffer->data = bufcpy(dim(byte_t, size), content, count);
 
     sourceBuffer->size = size;
+    sourceBuffer->capacity = size;
+    sourceBuffer->isMapped = FALSE;
+    sourceBuffer->isValidated = FALSE;
+    sourceBuffer->invalidOffset = 0;
+    sourceBuffer->lines = NULL;
+    sourceBuffer->encoding = CALC_SOURCE_ENCODING_UTF_8;
 
     return sourceBuffer;
 }
@@ -32,40 +57,110 @@ CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromText(const c
     else
         length = strlen(text);
 
-    return calcCreateSourceBuffer(length + 1, (byte_t *)text, length);
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBuffer(length + 1, (byte_t *)text, length);
+
+    calcValidateSourceBuffer(sourceBuffer);
+
+    return sourceBuffer;
 }
 
-CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromFile(const char *const path)
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromFile(const char *const path, CalcSourceEncoding_t encoding)
 {
     assert(path != NULL);
 
-    FILE *stream = fopen(path, CALC_LOADMOD);
-    CalcSourceBuffer_t *sourceBuffer;
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBufferFromMappedFile(path, encoding);
+    FILE *stream;
+
+    if (sourceBuffer)
+        return sourceBuffer;
 
-    if (!stream)
+    if (!(stream = fopen(path, CALC_LOADMOD)))
         sourceBuffer = NULL;
     else
-        sourceBuffer = calcCreateSourceBufferFromStream(stream), fclose(stream);
+        sourceBuffer = calcCreateSourceBufferFromStream(stream, encoding), fclose(stream);
 
     return sourceBuffer;
 }
 
-CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromStream(FILE *const stream)
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromMappedFile(const char *const path, CalcSourceEncoding_t encoding)
+{
+    assert(path != NULL);
+
+    CalcSourceBuffer_t *sourceBuffer;
+    byte_t *data;
+    size_t size, skip;
+
+    if (!(data = fmap(path, &size)))
+        return NULL;
+
+    sourceBuffer = alloc(CalcSourceBuffer_t);
+
+    // Like buffers created from text, the size includes the NUL sentinel.
+    sourceBuffer->data = data;
+    sourceBuffer->size = size + 1;
+    sourceBuffer->capacity = 0;
+    sourceBuffer->isMapped = TRUE;
+    sourceBuffer->isValidated = FALSE;
+    sourceBuffer->invalidOffset = 0;
+    sourceBuffer->lines = NULL;
+    sourceBuffer->encoding = calc_DetectSourceBom(data, size, encoding, &skip);
+
+    // Only the first page is touched to find the BOM: the content is copied
+    // when it must be transcoded, else it's validated on demand, so the pages
+    // of the file are faulted in only by its readers.
+    if (skip || ((sourceBuffer->encoding != CALC_SOURCE_ENCODING_ASCII) && (sourceBuffer->encoding != CALC_SOURCE_ENCODING_UTF_8)))
+        calcTranscodeSourceBuffer(sourceBuffer, encoding);
+
+    return sourceBuffer;
+}
+
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromLoadedFile(const char *const path, CalcSourceEncoding_t encoding)
+{
+    assert(path != NULL);
+
+    CalcSourceBuffer_t *sourceBuffer;
+    byte_t *data;
+    size_t size;
+
+    if (!(data = fload(path, &size)))
+        return NULL;
+
+    sourceBuffer = alloc(CalcSourceBuffer_t);
+
+    sourceBuffer->data = data;
+    sourceBuffer->size = size + 1;
+    sourceBuffer->capacity = size + 1;
+    sourceBuffer->isMapped = FALSE;
+    sourceBuffer->lines = NULL;
+
+    calcTranscodeSourceBuffer(sourceBuffer, encoding);
+
+    return sourceBuffer;
+}
+
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromStream(FILE *const stream, CalcSourceEncoding_t encoding)
 {
     assert(stream != NULL);
 
     size_t size = fgetsiz(stream);
-    size_t fpos = 0;
+    size_t fpos = 0, count;
 
-    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBuffer(size, NULL, 0);
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBuffer(size + 1, NULL, 0);
 
     byte_t *p = sourceBuffer->data;
 
-    do
-        fpos += fread(p + fpos, sizeof(byte_t), min(CALC_PAGESIZ, (size - fpos)), stream);
-    while (fpos < size);
+    while (fpos < size)
+    {
+        if (!(count = fread(p + fpos, sizeof(byte_t), min(CALC_PAGESIZ, (size - fpos)), stream)))
+            break;
+
+        fpos += count;
+    }
 
     p[fpos] = NUL;
+    sourceBuffer->size = fpos + 1;
+
+    calcTranscodeSourceBuffer(sourceBuffer, encoding);
 
     return sourceBuffer;
 }
@@ -74,29 +169,116 @@ CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromStdin(void)
 {
     CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBuffer(CALC_PAGESIZ, NULL, 0);
 
-    char *buffer = fgets((char *)sourceBuffer->data, CALC_PAGESIZ, stdin), *newBuffer;
-    size_t length = strlen(buffer);
+    bool_t isInteractive = fisatty(stdin);
+    size_t length = 0, count;
+    int c;
 
-    if (length < CALC_PAGESIZ)
+    for (;;)
     {
-        newBuffer = (char *)realloc((void *)buffer, length + 1);
+        // One byte is always left for the NUL terminator.
+        if ((length + 1) == sourceBuffer->size)
+            sourceBuffer->data = redim(byte_t, sourceBuffer->data, sourceBuffer->size <<= 1);
+
+        if (isInteractive)
+        {
+            if ((c = getc(stdin)) == EOF)
+                break;
 
-        if (newBuffer)
+            sourceBuffer->data[length++] = (byte_t)c;
+
+            if (c == EOL)
+                break;
+        }
+        else
         {
-            sourceBuffer->data = (byte_t *)newBuffer;
-            sourceBuffer->size = length + 1;
+            if (!(count = fread(sourceBuffer->data + length, sizeof(byte_t), sourceBuffer->size - length - 1, stdin)))
+                break;
+
+            length += count;
         }
     }
 
+    sourceBuffer->data[length] = NUL;
+    sourceBuffer->data = redim(byte_t, sourceBuffer->data, sourceBuffer->size = length + 1);
+    sourceBuffer->capacity = sourceBuffer->size;
+
+    calcTranscodeSourceBuffer(sourceBuffer, CALC_SOURCE_ENCODING_UTF_8);
+
     return sourceBuffer;
 }
 
+CALC_API bool_t CALC_STDCALL calcTranscodeSourceBuffer(CalcSourceBuffer_t *const sourceBuffer, CalcSourceEncoding_t encoding)
+{
+    size_t length = sourceBuffer->size ? (sourceBuffer->size - 1) : 0, skip = 0, count;
+    const byte_t *data = sourceBuffer->data;
+    byte_t *result;
+
+    sourceBuffer->encoding = encoding = calc_DetectSourceBom(data, length, encoding, &skip);
+
+    switch (encoding)
+    {
+    case CALC_SOURCE_ENCODING_LATIN_1:
+        result = dim(byte_t, ((length - skip) << 1) + 1);
+        count = utf8_from_latin1((const uint8_t *)(data + skip), length - skip, (uint8_t *)result);
+        break;
+
+    case CALC_SOURCE_ENCODING_UTF_16LE:
+        result = dim(byte_t, (((length - skip) >> 1) * 3) + 4);
+        count = utf8_from_utf16le((const uint8_t *)(data + skip), length - skip, (uint8_t *)result);
+        break;
+
+    default:
+        // ASCII and UTF-8 contents are kept as they are, unless the BOM must
+        // be removed.
+        if (!skip)
+            return calcValidateSourceBuffer(sourceBuffer);
+
+        count = length - skip;
+        result = bufcpy(dim(byte_t, count + 1), data + skip, count);
+        break;
+    }
+
+    result[count] = NUL;
+
+    if (sourceBuffer->isMapped)
+        funmap(sourceBuffer->data, length);
+    else
+        free(sourceBuffer->data);
+
+    if (sourceBuffer->lines)
+    {
+        calcDeleteSourceLines(sourceBuffer->lines);
+        sourceBuffer->lines = NULL;
+    }
+
+    sourceBuffer->data = redim(byte_t, result, count + 1);
+    sourceBuffer->size = sourceBuffer->capacity = count + 1;
+    sourceBuffer->isMapped = FALSE;
+
+    return calcValidateSourceBuffer(sourceBuffer);
+}
+
+CALC_API bool_t CALC_STDCALL calcValidateSourceBuffer(CalcSourceBuffer_t *const sourceBuffer)
+{
+    size_t length = sourceBuffer->size ? (sourceBuffer->size - 1) : 0;
+
+    sourceBuffer->invalidOffset = utf8_validate((const uint8_t *)sourceBuffer->data, length);
+
+    return sourceBuffer->isValidated = (bool_t)(sourceBuffer->invalidOffset == length);
+}
+
 CALC_API int32_t CALC_STDCALL calcSourceBufferGetChar(CalcSourceBuffer_t *const sourceBuffer, CalcSourceEncoding_t encoding, uint64_t position, ssize_t *const outOffset)
 {
     int32_t result;
     ssize_t offset;
 
-    if (position < sourceBuffer->size)
+    if ((position < sourceBuffer->size) && !(sourceBuffer->data[position] & 0x80))
+    {
+        // ASCII bytes are the same characters in every supported encoding.
+        result = sourceBuffer->data[position];
+        offset = 1;
+    }
+    else if (position < sourceBuffer->size)
     {
         switch (encoding)
         {
@@ -106,7 +288,18 @@ CALC_API int32_t CALC_STDCALL calcSourceBufferGetChar(CalcSourceBuffer_t *const
             break;
 
         case CALC_SOURCE_ENCODING_UTF_8:
+        case CALC_SOURCE_ENCODING_LATIN_1:
+        case CALC_SOURCE_ENCODING_UTF_16LE:
+            // Validated buffers are decoded without checks, unless the
+            // position is in the middle of a sequence.
+            if (sourceBuffer->isValidated && ((offset = utf8_decode((const uint8_t *)(sourceBuffer->data + position), &result)) > 0))
+                break;
+
             offset = utf8_iterate((const uint8_t *)(sourceBuffer->data + position), (ssize_t)(sourceBuffer->size - position), &result);
+
+            if (offset < 0)
+                result = CALC_SOURCE_INVALID_CHAR, offset = 1;
+
             break;
 
         default:
@@ -116,9 +309,10 @@ CALC_API int32_t CALC_STDCALL calcSourceBufferGetChar(CalcSourceBuffer_t *const
     else
     {
         result = EOF;
+        offset = 0;
     }
 
-    if (outOffset && *outOffset)
+    if (outOffset)
         *outOffset = offset;
 
     return result;
@@ -131,12 +325,28 @@ CALC_API int CALC_STDCALL calcDumpSourceBuffer(const CalcSourceBuffer_t *const s
 
 CALC_API bool_t CALC_STDCALL calcClearSourceBuffer(CalcSourceBuffer_t *const sourceBuffer)
 {
+    if (sourceBuffer->isMapped)
+        return FALSE;
+
+    if (sourceBuffer->lines)
+    {
+        calcDeleteSourceLines(sourceBuffer->lines);
+        sourceBuffer->lines = NULL;
+    }
+
     return (bool_t)(!!bufclr(sourceBuffer->data, sourceBuffer->size));
 }
 
 CALC_API void CALC_STDCALL calcDeleteSourceBuffer(CalcSourceBuffer_t *const sourceBuffer)
 {
-    free(sourceBuffer->data);
+    if (sourceBuffer->isMapped)
+        funmap(sourceBuffer->data, sourceBuffer->size - 1);
+    else
+        free(sourceBuffer->data);
+
+    if (sourceBuffer->lines)
+        calcDeleteSourceLines(sourceBuffer->lines);
+
     free(sourceBuffer);
 
     return;
@@ -0,0 +1,301 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/file.h"
+#include "calc/base/string.h"
+#include "calc/core/hash.h"
+
+#include "calc/source/source_cache.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef CALC_SOURCE_CACHE_HASH_BLOCK
+/// @brief This constant macro represents the number of bytes hashed on each
+///        update of a fingerprint.
+#   define CALC_SOURCE_CACHE_HASH_BLOCK (CALC_PAGESIZ << 4)
+#endif // CALC_SOURCE_CACHE_HASH_BLOCK
+
+CALC_API bool_t CALC_STDCALL calcGetSourceFileStatus(const char *const path, CalcSourceFileStatus_t *const outStatus)
+{
+#if CALC_PLATFORM_IS_WINDOWS
+    struct _stat64 status;
+
+    if (_stat64(path, &status))
+        return FALSE;
+
+    outStatus->device = (uint64_t)status.st_dev;
+    outStatus->inode = (uint64_t)status.st_ino;
+    outStatus->size = (uint64_t)status.st_size;
+    outStatus->mtime = (uint64_t)status.st_mtime;
+#else
+    struct stat status;
+
+    if (stat(path, &status) || !S_ISREG(status.st_mode))
+        return FALSE;
+
+    outStatus->device = (uint64_t)status.st_dev;
+    outStatus->inode = (uint64_t)status.st_ino;
+    outStatus->size = (uint64_t)status.st_size;
+#   if CALC_PLATFORM_ID == CALC_PLATFORM_ID_MACOS
+    outStatus->mtime = (uint64_t)status.st_mtimespec.tv_sec * 1000000000 + (uint64_t)status.st_mtimespec.tv_nsec;
+#   elif CALC_PLATFORM_ID == CALC_PLATFORM_ID_LINUX
+    outStatus->mtime = (uint64_t)status.st_mtim.tv_sec * 1000000000 + (uint64_t)status.st_mtim.tv_nsec;
+#   else
+    outStatus->mtime = (uint64_t)status.st_mtime;
+#   endif
+#endif
+
+    return TRUE;
+}
+
+CALC_API CalcSourceCache_t *CALC_STDCALL calcCreateSourceCache(void)
+{
+    CalcSourceCache_t *sourceCache = alloc(CalcSourceCache_t);
+    size_t i;
+
+    for (i = 0; i < CALC_SOURCE_CACHE_BUCKETS; i++)
+    {
+        sourceCache->buckets[i] = NULL;
+        sourceCache->artifacts[i] = NULL;
+    }
+
+    sourceCache->count = 0;
+    sourceCache->artifactCount = 0;
+
+    return sourceCache;
+}
+
+CALC_API void CALC_STDCALL calcSourceBufferFingerprint(const CalcSourceBuffer_t *const sourceBuffer, byte_t *const outHash)
+{
+    CalcSha256Context_t context;
+    size_t length = sourceBuffer->size ? (sourceBuffer->size - 1) : 0, i, chunk;
+
+    calcSha256ContextInit(&context);
+
+    // Mapped files are read while they're hashed, one block at a time.
+    for (i = 0; i < length; i += chunk)
+    {
+        chunk = min(length - i, (size_t)CALC_SOURCE_CACHE_HASH_BLOCK);
+
+        calcSha256Update(&context, sourceBuffer->data + i, chunk, NULL);
+    }
+
+    calcSha256Final(&context, outHash);
+
+    return;
+}
+
+/// @brief Loads a source file in blocks, fingerprinting each block as soon as
+///        it's read, while it's still in the cache of the processor. Cached
+///        files are expected to change, so they're never mapped: the buffers
+///        given to the callers must outlive the next rewrite.
+static CalcSourceBuffer_t *CALC_STDCALL calc_LoadSourceCacheFile(const char *const path, size_t size, byte_t *const outHash)
+{
+    CalcSha256Context_t context;
+    CalcSourceBuffer_t *sourceBuffer;
+    size_t count = 0, chunk;
+    FILE *stream;
+
+    if (!(stream = fopen(path, CALC_LOADMOD)))
+        return NULL;
+
+    sourceBuffer = calcCreateSourceBuffer(size + 1, NULL, 0);
+
+    calcSha256ContextInit(&context);
+
+    // The file may shrink after its status is got, its new end is loaded.
+    while ((count < size) && (chunk = fread(sourceBuffer->data + count, sizeof(byte_t), min(size - count, (size_t)CALC_SOURCE_CACHE_HASH_BLOCK), stream)))
+    {
+        calcSha256Update(&context, sourceBuffer->data + count, chunk, NULL);
+        count += chunk;
+    }
+
+    if (ferror(stream))
+    {
+        fclose(stream);
+        calcDeleteSourceBuffer(sourceBuffer);
+
+        return NULL;
+    }
+
+    fclose(stream);
+    calcSha256Final(&context, outHash);
+
+    sourceBuffer->data[count] = NUL;
+    sourceBuffer->size = count + 1;
+
+    calcTranscodeSourceBuffer(sourceBuffer, CALC_SOURCE_ENCODING_UTF_8);
+
+    return sourceBuffer;
+}
+
+/// @brief Gets the bucket of the artifacts of a fingerprint, the fingerprints
+///        are already uniformly distributed.
+static inline CalcSourceArtifact_t **CALC_STDCALL calc_GetSourceArtifactBucket(CalcSourceCache_t *const sourceCache, const byte_t *const hash)
+{
+    return &sourceCache->artifacts[(((size_t)hash[0] << 8) | (size_t)hash[1]) % CALC_SOURCE_CACHE_BUCKETS];
+}
+
+/// @brief Gets the artifact of a fingerprint, adding an empty one to the
+///        table when no entry has that content.
+static CalcSourceArtifact_t *CALC_STDCALL calc_AcquireSourceArtifact(CalcSourceCache_t *const sourceCache, const byte_t *const hash)
+{
+    CalcSourceArtifact_t *sourceArtifact, **bucket = calc_GetSourceArtifactBucket(sourceCache, hash);
+
+    for (sourceArtifact = *bucket; sourceArtifact; sourceArtifact = sourceArtifact->next)
+    {
+        if (bufcmp(sourceArtifact->hash, hash, CALC_SHA256_BLOCK_SIZE))
+            return sourceArtifact->references++, sourceArtifact;
+    }
+
+    sourceArtifact = alloc(CalcSourceArtifact_t);
+
+    bufcpy(sourceArtifact->hash, hash, CALC_SHA256_BLOCK_SIZE);
+
+    sourceArtifact->data = NULL;
+    sourceArtifact->deleter = NULL;
+    sourceArtifact->references = 1;
+    sourceArtifact->next = *bucket;
+
+    *bucket = sourceArtifact;
+    sourceCache->artifactCount++;
+
+    return sourceArtifact;
+}
+
+static inline void CALC_STDCALL calc_DeleteSourceArtifact(CalcSourceArtifact_t *const sourceArtifact)
+{
+    if (sourceArtifact->data && sourceArtifact->deleter)
+        sourceArtifact->deleter(sourceArtifact->data);
+
+    free(sourceArtifact);
+
+    return;
+}
+
+/// @brief Releases the artifact of an entry whose content is changed, the
+///        artifact is deleted when no other entry has that content.
+static void CALC_STDCALL calc_ReleaseSourceArtifact(CalcSourceCache_t *const sourceCache, CalcSourceArtifact_t *const sourceArtifact)
+{
+    CalcSourceArtifact_t **link;
+
+    if (--sourceArtifact->references)
+        return;
+
+    for (link = calc_GetSourceArtifactBucket(sourceCache, sourceArtifact->hash); *link != sourceArtifact; link = &(*link)->next)
+        ;
+
+    *link = sourceArtifact->next;
+    sourceCache->artifactCount--;
+
+    calc_DeleteSourceArtifact(sourceArtifact);
+
+    return;
+}
+
+CALC_API CalcSourceCacheEntry_t *CALC_STDCALL calcSourceCacheLookup(CalcSourceCache_t *const sourceCache, const char *const path, CalcSourceBuffer_t **const outBuffer)
+{
+    CalcSourceCacheEntry_t *sourceCacheEntry, **bucket = &sourceCache->buckets[calcGetSimpleHashCode((const byte_t *)path) % CALC_SOURCE_CACHE_BUCKETS];
+    CalcSourceBuffer_t *sourceBuffer;
+    CalcSourceFileStatus_t status;
+    CalcSha256HashBlock_t hash;
+
+    if (outBuffer)
+        *outBuffer = NULL;
+
+    if (!calcGetSourceFileStatus(path, &status))
+        return NULL;
+
+    for (sourceCacheEntry = *bucket; sourceCacheEntry; sourceCacheEntry = sourceCacheEntry->next)
+    {
+        if (!strcmp(sourceCacheEntry->path, path))
+            break;
+    }
+
+    // Unchanged metadata: the file is not read at all.
+    if (sourceCacheEntry && (sourceCacheEntry->device == status.device) && (sourceCacheEntry->inode == status.inode) && (sourceCacheEntry->size == status.size) && (sourceCacheEntry->mtime == status.mtime))
+        return sourceCacheEntry;
+
+    if (!(sourceBuffer = calc_LoadSourceCacheFile(path, (size_t)status.size, hash)))
+        return NULL;
+
+    if (!sourceCacheEntry)
+    {
+        sourceCacheEntry = alloc(CalcSourceCacheEntry_t);
+
+        sourceCacheEntry->path = strget(path);
+        sourceCacheEntry->artifact = calc_AcquireSourceArtifact(sourceCache, hash);
+        sourceCacheEntry->next = *bucket;
+
+        *bucket = sourceCacheEntry;
+        sourceCache->count++;
+    }
+    else if (!bufcmp(sourceCacheEntry->hash, hash, CALC_SHA256_BLOCK_SIZE))
+    {
+        // The content is changed, so the entry moves to the artifact of the
+        // new content, the stale one is kept while other files have it.
+        calc_ReleaseSourceArtifact(sourceCache, sourceCacheEntry->artifact);
+        sourceCacheEntry->artifact = calc_AcquireSourceArtifact(sourceCache, hash);
+    }
+
+    bufcpy(sourceCacheEntry->hash, hash, CALC_SHA256_BLOCK_SIZE);
+
+    sourceCacheEntry->device = status.device;
+    sourceCacheEntry->inode = status.inode;
+    sourceCacheEntry->size = status.size;
+    sourceCacheEntry->mtime = status.mtime;
+
+    if (outBuffer)
+        *outBuffer = sourceBuffer;
+    else
+        calcDeleteSourceBuffer(sourceBuffer);
+
+    return sourceCacheEntry;
+}
+
+CALC_API void CALC_STDCALL calcSourceCacheSetArtifact(CalcSourceCacheEntry_t *const sourceCacheEntry, void *const artifact, CalcSourceArtifactDeleter_t deleter)
+{
+    CalcSourceArtifact_t *sourceArtifact = sourceCacheEntry->artifact;
+
+    if (sourceArtifact->data && sourceArtifact->deleter && (sourceArtifact->data != artifact))
+        sourceArtifact->deleter(sourceArtifact->data);
+
+    sourceArtifact->data = artifact;
+    sourceArtifact->deleter = deleter;
+
+    return;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourceCache(CalcSourceCache_t *const sourceCache)
+{
+    CalcSourceCacheEntry_t *sourceCacheEntry, *next;
+    CalcSourceArtifact_t *sourceArtifact, *nextArtifact;
+    size_t i;
+
+    for (i = 0; i < CALC_SOURCE_CACHE_BUCKETS; i++)
+    {
+        for (sourceCacheEntry = sourceCache->buckets[i]; sourceCacheEntry; sourceCacheEntry = next)
+        {
+            next = sourceCacheEntry->next;
+
+            free(sourceCacheEntry->path);
+            free(sourceCacheEntry);
+        }
+
+        for (sourceArtifact = sourceCache->artifacts[i]; sourceArtifact; sourceArtifact = nextArtifact)
+        {
+            nextArtifact = sourceArtifact->next;
+
+            calc_DeleteSourceArtifact(sourceArtifact);
+        }
+    }
+
+    free(sourceCache);
+
+    return;
+}
@@ -0,0 +1,413 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/path.h"
+#include "calc/base/string.h"
+#include "calc/core/hash.h"
+
+#include "calc/source/source_include.h"
+
+static inline bool_t CALC_STDCALL calc_IsSourceBlank(byte_t c)
+{
+    return (bool_t)((c == ' ') || (c == '\t'));
+}
+
+static inline bool_t CALC_STDCALL calc_IsSourceWordChar(byte_t c)
+{
+    return (bool_t)(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_'));
+}
+
+static inline const byte_t *CALC_STDCALL calc_SkipSourceBlanks(const byte_t *p, const byte_t *const end)
+{
+    while ((p < end) && calc_IsSourceBlank(*p))
+        p++;
+
+    return p;
+}
+
+/// @brief Skips whitespaces and comments.
+static const byte_t *CALC_STDCALL calc_SkipSourceTrivia(const byte_t *p, const byte_t *const end)
+{
+    for (;;)
+    {
+        while ((p < end) && (calc_IsSourceBlank(*p) || (*p == EOL) || (*p == '\r') || (*p == '\v') || (*p == '\f')))
+            p++;
+
+        if (((p + 1) < end) && (p[0] == '/') && (p[1] == '/'))
+        {
+            while ((p < end) && (*p != EOL))
+                p++;
+        }
+        else if (((p + 1) < end) && (p[0] == '/') && (p[1] == '*'))
+        {
+            for (p += 2; ((p + 1) < end) && !((p[0] == '*') && (p[1] == '/')); p++)
+                ;
+
+            p = min(p + 2, end);
+        }
+        else
+        {
+            return p;
+        }
+    }
+}
+
+static inline size_t CALC_STDCALL calc_ScanSourceWord(const byte_t *const p, const byte_t *const end)
+{
+    size_t length = 0;
+
+    while (((p + length) < end) && calc_IsSourceWordChar(p[length]))
+        length++;
+
+    return length;
+}
+
+/// @brief Matches a directive at the beginning of a sequence of bytes.
+/// @return A pointer next to the name of the directive, or NULL.
+static const byte_t *CALC_STDCALL calc_ScanSourceDirective(const byte_t *p, const byte_t *const end, const char *const directive)
+{
+    size_t length = strlen(directive);
+
+    if ((p == end) || (*p != '#'))
+        return NULL;
+
+    p = calc_SkipSourceBlanks(p + 1, end);
+
+    if ((calc_ScanSourceWord(p, end) != length) || memcmp(p, directive, length))
+        return NULL;
+
+    return p + length;
+}
+
+/// @brief Finds out if an included file begins with '#pragma once', or if its
+///        whole content is wrapped by an include guard.
+static void CALC_STDCALL calc_DetectSourceGuard(CalcSourceInclude_t *const sourceInclude)
+{
+    const byte_t *p = sourceInclude->buffer->data, *end = p + (sourceInclude->buffer->size ? (sourceInclude->buffer->size - 1) : 0), *name, *q;
+    size_t length, nameLength, depth = 1;
+
+    sourceInclude->isOnce = FALSE;
+
+    if (sourceInclude->guard)
+    {
+        free(sourceInclude->guard);
+        sourceInclude->guard = NULL;
+    }
+
+    p = calc_SkipSourceTrivia(p, end);
+
+    if ((q = calc_ScanSourceDirective(p, end, "pragma")) != NULL)
+    {
+        q = calc_SkipSourceBlanks(q, end);
+        sourceInclude->isOnce = (bool_t)((calc_ScanSourceWord(q, end) == 4) && !memcmp(q, "once", 4));
+
+        return;
+    }
+
+    if (!(q = calc_ScanSourceDirective(p, end, "ifndef")))
+        return;
+
+    name = calc_SkipSourceBlanks(q, end);
+
+    if (!(nameLength = calc_ScanSourceWord(name, end)))
+        return;
+
+    p = calc_SkipSourceTrivia(name + nameLength, end);
+
+    if (!(q = calc_ScanSourceDirective(p, end, "define")))
+        return;
+
+    q = calc_SkipSourceBlanks(q, end);
+
+    if ((calc_ScanSourceWord(q, end) != nameLength) || memcmp(q, name, nameLength))
+        return;
+
+    // The '#endif' that closes the '#ifndef' must be the last thing of the
+    // file, conditional directives are matched line by line.
+    for (p = q; p < end; p++)
+    {
+        while ((p < end) && (*p != EOL))
+            p++;
+
+        q = calc_SkipSourceBlanks(p + (p < end), end);
+
+        if ((q == end) || (*q != '#'))
+            continue;
+
+        q = calc_SkipSourceBlanks(q + 1, end);
+        length = calc_ScanSourceWord(q, end);
+
+        if ((length >= 2) && !memcmp(q, "if", 2))
+            depth++;
+        else if ((length == 5) && !memcmp(q, "endif", 5) && !--depth)
+            break;
+    }
+
+    if (!depth && (calc_SkipSourceTrivia(q + 5, end) == end))
+        sourceInclude->guard = strnget((const char *)name, nameLength);
+
+    return;
+}
+
+/// @brief Gets the include of a file, looking it up in the source cache by its
+///        path and then by its identity: files reached through different
+///        paths share their include. The file is loaded in a new include when
+///        its content is changed, the superseded include is left alive.
+static CalcSourceInclude_t *CALC_STDCALL calc_GetSourceInclude(CalcSourceIncludeCache_t *const sourceIncludeCache, const char *const path)
+{
+    CalcSourceCacheEntry_t *sourceCacheEntry;
+    CalcSourceIdentity_t *sourceIdentity, **bucket;
+    CalcSourceInclude_t *sourceInclude;
+    CalcSourceBuffer_t *sourceBuffer;
+
+    if (!(sourceCacheEntry = calcSourceCacheLookup(sourceIncludeCache->cache, path, &sourceBuffer)))
+        return NULL;
+
+    bucket = &sourceIncludeCache->identities[(size_t)((sourceCacheEntry->device ^ sourceCacheEntry->inode) % CALC_SOURCE_INCLUDE_CACHE_BUCKETS)];
+
+    for (sourceIdentity = *bucket; sourceIdentity; sourceIdentity = sourceIdentity->next)
+    {
+        if ((sourceIdentity->device == sourceCacheEntry->device) && (sourceIdentity->inode == sourceCacheEntry->inode))
+            break;
+    }
+
+    // Files that are unchanged, or touched with the same fingerprint, keep
+    // their include, whatever path they're reached through.
+    if (sourceIdentity && bufcmp(sourceIdentity->include->hash, sourceCacheEntry->hash, CALC_SHA256_BLOCK_SIZE))
+    {
+        if (sourceBuffer)
+            calcDeleteSourceBuffer(sourceBuffer);
+
+        return sourceIdentity->include;
+    }
+
+    if (!sourceBuffer && !(sourceBuffer = calcCreateSourceBufferFromLoadedFile(path, CALC_SOURCE_ENCODING_UTF_8)))
+        return NULL;
+
+    sourceInclude = alloc(CalcSourceInclude_t);
+
+    sourceInclude->path = strget(path);
+    sourceInclude->buffer = sourceBuffer;
+    sourceInclude->isOnce = FALSE;
+    sourceInclude->guard = NULL;
+    sourceInclude->unit = 0;
+    sourceInclude->next = sourceIncludeCache->includes;
+
+    bufcpy(sourceInclude->hash, sourceCacheEntry->hash, CALC_SHA256_BLOCK_SIZE);
+
+    sourceIncludeCache->includes = sourceInclude;
+    sourceIncludeCache->loads++;
+
+    calc_DetectSourceGuard(sourceInclude);
+
+    if (!sourceIdentity)
+    {
+        sourceIdentity = alloc(CalcSourceIdentity_t);
+
+        sourceIdentity->device = sourceCacheEntry->device;
+        sourceIdentity->inode = sourceCacheEntry->inode;
+        sourceIdentity->next = *bucket;
+
+        *bucket = sourceIdentity;
+    }
+
+    return (sourceIdentity->include = sourceInclude);
+}
+
+/// @brief Probes the file system for a file in a directory, getting its
+///        include when it exists.
+static CalcSourceInclude_t *CALC_STDCALL calc_ProbeSourceInclude(CalcSourceIncludeCache_t *const sourceIncludeCache, const char *const directory, size_t length, const char *const name)
+{
+    size_t nameLength = strlen(name);
+    char *path = dim(char, length + nameLength + 2);
+    CalcSourceInclude_t *sourceInclude;
+
+    memcpy(path, directory, length);
+
+    if (length && !calcIsDirSep(directory[length - 1]))
+        path[length++] = '/';
+
+    memcpy(path + length, name, nameLength + 1);
+
+    sourceIncludeCache->probes++;
+    sourceInclude = calc_GetSourceInclude(sourceIncludeCache, path);
+
+    free(path);
+
+    return sourceInclude;
+}
+
+CALC_API CalcSourceIncludeCache_t *CALC_STDCALL calcCreateSourceIncludeCache(const char *const searchPaths)
+{
+    CalcSourceIncludeCache_t *sourceIncludeCache = alloc(CalcSourceIncludeCache_t);
+    const char *p, *q;
+    char *directory;
+    size_t i;
+
+    sourceIncludeCache->paths = NULL;
+    sourceIncludeCache->pathCount = 0;
+    sourceIncludeCache->cache = calcCreateSourceCache();
+    sourceIncludeCache->includes = NULL;
+    sourceIncludeCache->unit = 1;
+    sourceIncludeCache->loads = 0;
+    sourceIncludeCache->probes = 0;
+
+    for (i = 0; i < CALC_SOURCE_INCLUDE_CACHE_BUCKETS; i++)
+    {
+        sourceIncludeCache->resolutions[i] = NULL;
+        sourceIncludeCache->identities[i] = NULL;
+    }
+
+    for (p = searchPaths; p && *p; p = *q ? (q + 1) : q)
+    {
+        if (!(q = strchr(p, CALC_PATHSEP)))
+            q = p + strlen(p);
+
+        if (q != p)
+        {
+            calcAddSourceIncludePath(sourceIncludeCache, directory = strnget(p, (size_t)(q - p)));
+            free(directory);
+        }
+    }
+
+    return sourceIncludeCache;
+}
+
+CALC_API void CALC_STDCALL calcAddSourceIncludePath(CalcSourceIncludeCache_t *const sourceIncludeCache, const char *const directory)
+{
+    sourceIncludeCache->paths = redim(char *, sourceIncludeCache->paths, sourceIncludeCache->pathCount + 1);
+    sourceIncludeCache->paths[sourceIncludeCache->pathCount++] = strget(directory);
+
+    return;
+}
+
+CALC_API CalcSourceInclude_t *CALC_STDCALL calcSourceIncludeCacheResolve(CalcSourceIncludeCache_t *const sourceIncludeCache, const char *const name, const char *const includer)
+{
+    assert(name != NULL);
+
+    CalcSourceResolution_t *sourceResolution, **bucket = &sourceIncludeCache->resolutions[calcGetSimpleHashCode((const byte_t *)name) % CALC_SOURCE_INCLUDE_CACHE_BUCKETS];
+    CalcSourceInclude_t *sourceInclude = NULL;
+    size_t length = 0, i;
+
+    // The directory of the includer matters only for relative names.
+    if (includer && !calcIsAbsPath(name))
+    {
+        for (i = 0; includer[i]; i++)
+        {
+            if (calcIsDirSep(includer[i]))
+                length = i + 1;
+        }
+    }
+
+    for (sourceResolution = *bucket; sourceResolution; sourceResolution = sourceResolution->next)
+    {
+        if (!strcmp(sourceResolution->name, name) && (strlen(sourceResolution->directory) == length) && (!length || !strncmp(sourceResolution->directory, includer, length)))
+            break;
+    }
+
+    // A resolved name costs a stat of its file, unless it's gone.
+    if (sourceResolution && ((sourceInclude = calc_GetSourceInclude(sourceIncludeCache, sourceResolution->include->path)) != NULL))
+        return (sourceResolution->include = sourceInclude);
+
+    if (calcIsAbsPath(name))
+        sourceInclude = calc_ProbeSourceInclude(sourceIncludeCache, "", 0, name);
+    else if (includer)
+        sourceInclude = calc_ProbeSourceInclude(sourceIncludeCache, includer, length, name);
+
+    for (i = 0; !sourceInclude && !calcIsAbsPath(name) && (i < sourceIncludeCache->pathCount); i++)
+        sourceInclude = calc_ProbeSourceInclude(sourceIncludeCache, sourceIncludeCache->paths[i], strlen(sourceIncludeCache->paths[i]), name);
+
+    if (!sourceInclude)
+        return NULL;
+
+    if (!sourceResolution)
+    {
+        sourceResolution = alloc(CalcSourceResolution_t);
+
+        sourceResolution->directory = strnget(includer ? includer : "", length);
+        sourceResolution->name = strget(name);
+        sourceResolution->next = *bucket;
+
+        *bucket = sourceResolution;
+    }
+
+    return (sourceResolution->include = sourceInclude);
+}
+
+CALC_API void CALC_STDCALL calcSourceIncludeCacheBeginUnit(CalcSourceIncludeCache_t *const sourceIncludeCache)
+{
+    sourceIncludeCache->unit++;
+
+    return;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourceIncludeCacheEnter(CalcSourceIncludeCache_t *const sourceIncludeCache, CalcSourceInclude_t *const sourceInclude, CalcSourceMacroPredicate_t isDefined, void *const context)
+{
+    // The first inclusion in a unit is always lexed.
+    if (sourceInclude->unit != sourceIncludeCache->unit)
+        return sourceInclude->unit = sourceIncludeCache->unit, TRUE;
+
+    if (sourceInclude->isOnce)
+        return FALSE;
+
+    if (sourceInclude->guard)
+        return (bool_t)(isDefined && !isDefined(context, sourceInclude->guard));
+
+    return TRUE;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourceIncludeCache(CalcSourceIncludeCache_t *const sourceIncludeCache)
+{
+    CalcSourceResolution_t *sourceResolution, *nextResolution;
+    CalcSourceIdentity_t *sourceIdentity, *nextIdentity;
+    CalcSourceInclude_t *sourceInclude, *nextInclude;
+    size_t i;
+
+    for (i = 0; i < CALC_SOURCE_INCLUDE_CACHE_BUCKETS; i++)
+    {
+        for (sourceResolution = sourceIncludeCache->resolutions[i]; sourceResolution; sourceResolution = nextResolution)
+        {
+            nextResolution = sourceResolution->next;
+
+            free(sourceResolution->directory);
+            free(sourceResolution->name);
+            free(sourceResolution);
+        }
+
+        for (sourceIdentity = sourceIncludeCache->identities[i]; sourceIdentity; sourceIdentity = nextIdentity)
+        {
+            nextIdentity = sourceIdentity->next;
+
+            free(sourceIdentity);
+        }
+    }
+
+    for (sourceInclude = sourceIncludeCache->includes; sourceInclude; sourceInclude = nextInclude)
+    {
+        nextInclude = sourceInclude->next;
+
+        calcDeleteSourceBuffer(sourceInclude->buffer);
+
+        if (sourceInclude->guard)
+            free(sourceInclude->guard);
+
+        free(sourceInclude->path);
+        free(sourceInclude);
+    }
+
+    calcDeleteSourceCache(sourceIncludeCache->cache);
+
+    for (i = 0; i < sourceIncludeCache->pathCount; i++)
+        free(sourceIncludeCache->paths[i]);
+
+    if (sourceIncludeCache->paths)
+        free(sourceIncludeCache->paths);
+
+    free(sourceIncludeCache);
+
+    return;
+}
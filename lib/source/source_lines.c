@@ -0,0 +1,83 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+
+#include "calc/source/source_lines.h"
+
+CALC_API CalcSourceLines_t *CALC_STDCALL calcCreateSourceLines(const CalcSourceBuffer_t *const sourceBuffer)
+{
+    CalcSourceLines_t *sourceLines = alloc(CalcSourceLines_t);
+
+    const byte_t *data = sourceBuffer->data, *p, *end;
+    size_t count = 1;
+
+    sourceLines->length = sourceBuffer->size ? (sourceBuffer->size - 1) : 0;
+
+    end = data + sourceLines->length;
+
+    // The first pass counts the lines, so the index is allocated once.
+    for (p = data; (p = (const byte_t *)memchr(p, EOL, (size_t)(end - p))) != NULL; p++)
+        count++;
+
+    sourceLines->starts = dim(size_t, count);
+    sourceLines->starts[0] = 0;
+    sourceLines->count = 1;
+
+    for (p = data; (p = (const byte_t *)memchr(p, EOL, (size_t)(end - p))) != NULL; p++)
+        sourceLines->starts[sourceLines->count++] = (size_t)(p - data) + 1;
+
+    return sourceLines;
+}
+
+CALC_API CalcSourceLines_t *CALC_STDCALL calcGetSourceLines(CalcSourceBuffer_t *const sourceBuffer)
+{
+    if (!sourceBuffer->lines)
+        sourceBuffer->lines = calcCreateSourceLines(sourceBuffer);
+
+    return sourceBuffer->lines;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourceBufferFindLine(CalcSourceBuffer_t *const sourceBuffer, size_t offset, CalcSourceLine_t *const outLine)
+{
+    CalcSourceLines_t *sourceLines = calcGetSourceLines(sourceBuffer);
+    size_t lo = 0, hi = sourceLines->count, mid, end;
+
+    if (offset > sourceLines->length)
+        return FALSE;
+
+    // Looks for the last line that begins at or before the offset.
+    while ((hi - lo) > 1)
+    {
+        mid = lo + ((hi - lo) >> 1);
+
+        if (sourceLines->starts[mid] <= offset)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    if ((lo + 1) < sourceLines->count)
+        end = sourceLines->starts[lo + 1] - 1;
+    else
+        end = sourceLines->length;
+
+    outLine->text = sourceBuffer->data + sourceLines->starts[lo];
+    outLine->length = end - sourceLines->starts[lo];
+    outLine->ln = (uint64_t)lo;
+    outLine->co = (uint64_t)(offset - sourceLines->starts[lo]);
+
+    return TRUE;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourceLines(CalcSourceLines_t *const sourceLines)
+{
+    free(sourceLines->starts);
+    free(sourceLines);
+
+    return;
+}
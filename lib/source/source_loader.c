@@ -0,0 +1,102 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/thread.h"
+
+#include "calc/source/source_loader.h"
+
+/// @brief The state shared by the threads of a batch load.
+typedef struct _CalcSourceLoad
+{
+    const char *const   *paths;
+    CalcSourceBuffer_t **sourceBuffers;
+    size_t               count;
+    size_t               next;
+    CalcSourceEncoding_t encoding;
+    handle_t             mutex;
+} CalcSourceLoad_t;
+
+static void CALC_STDCALL calc_SourceLoaderRun(void *arg)
+{
+    CalcSourceLoad_t *sourceLoad = (CalcSourceLoad_t *)arg;
+    size_t i;
+
+    for (;;)
+    {
+        // Files are claimed one at a time, so a slow one doesn't hold back
+        // the others.
+        mtxlock(sourceLoad->mutex);
+        i = sourceLoad->next++;
+        mtxunlock(sourceLoad->mutex);
+
+        if (i >= sourceLoad->count)
+            break;
+
+        if (sourceLoad->paths[i])
+            sourceLoad->sourceBuffers[i] = calcCreateSourceBufferFromLoadedFile(sourceLoad->paths[i], sourceLoad->encoding);
+    }
+
+    return;
+}
+
+CALC_API CalcSourceBuffer_t **CALC_STDCALL calcLoadSourceBuffers(const char *const *const paths, size_t count, size_t threadCount, CalcSourceEncoding_t encoding)
+{
+    assert(paths != NULL);
+
+    CalcSourceBuffer_t **sourceBuffers = dim(CalcSourceBuffer_t *, max(count, 1));
+    CalcSourceLoad_t sourceLoad;
+    handle_t *threads;
+    size_t i, spawned = 0;
+
+    if (!threadCount)
+        threadCount = (size_t)thrdcount() * CALC_SOURCE_LOADER_THREADS_PER_CORE;
+
+    threadCount = min(threadCount, count);
+
+    sourceLoad.paths = paths;
+    sourceLoad.sourceBuffers = sourceBuffers;
+    sourceLoad.count = count;
+    sourceLoad.next = 0;
+    sourceLoad.encoding = encoding;
+    sourceLoad.mutex = mtxcreate();
+
+    // The calling thread loads files too, so it's one of the threads.
+    threads = dim(handle_t, max(threadCount, 1));
+
+    for (i = 1; i < threadCount; i++)
+    {
+        if (!(threads[spawned] = thrdspawn(calc_SourceLoaderRun, (void *)&sourceLoad)))
+            break;
+
+        spawned++;
+    }
+
+    calc_SourceLoaderRun((void *)&sourceLoad);
+
+    for (i = 0; i < spawned; i++)
+        thrdjoin(threads[i]);
+
+    free(threads);
+    mtxdelete(sourceLoad.mutex);
+
+    return sourceBuffers;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourceBuffers(CalcSourceBuffer_t **const sourceBuffers, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (sourceBuffers[i])
+            calcDeleteSourceBuffer(sourceBuffers[i]);
+    }
+
+    free(sourceBuffers);
+
+    return;
+}
@@ -0,0 +1,127 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+
+#include "calc/source/source_manager.h"
+
+CALC_API CalcSourceManager_t *CALC_STDCALL calcCreateSourceManager(void)
+{
+    CalcSourceManager_t *sourceManager = alloc(CalcSourceManager_t);
+
+    sourceManager->entries = NULL;
+    sourceManager->count = 0;
+    sourceManager->capacity = 0;
+    sourceManager->next = CALC_SOURCE_INVALID_LOC + 1;
+
+    return sourceManager;
+}
+
+CALC_API CalcSourceEntry_t *CALC_STDCALL calcSourceManagerAdd(CalcSourceManager_t *const sourceManager, const char *const path, bool_t cleanupPath, CalcSourceBuffer_t *const sourceBuffer)
+{
+    CalcSourceEntry_t *sourceEntry;
+
+    if (sourceBuffer->size > (size_t)(UINT32_MAX - sourceManager->next))
+        return NULL;
+
+    if (sourceManager->count == sourceManager->capacity)
+    {
+        sourceManager->capacity = sourceManager->capacity ? (sourceManager->capacity << 1) : 16;
+        sourceManager->entries = redim(CalcSourceEntry_t *, sourceManager->entries, sourceManager->capacity);
+    }
+
+    // Entries are allocated one by one, so they never move.
+    sourceEntry = sourceManager->entries[sourceManager->count++] = alloc(CalcSourceEntry_t);
+
+    sourceEntry->path = (char *)path;
+    sourceEntry->buffer = sourceBuffer;
+    sourceEntry->base = sourceManager->next;
+    sourceEntry->cleanup = cleanupPath;
+
+    sourceManager->next += (CalcSourceLoc_t)sourceBuffer->size;
+
+    return sourceEntry;
+}
+
+CALC_API CalcSourceEntry_t *CALC_STDCALL calcSourceManagerLoadFile(CalcSourceManager_t *const sourceManager, const char *const path, bool_t cleanupPath)
+{
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBufferFromFile(path, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceEntry_t *sourceEntry;
+
+    if (!sourceBuffer)
+        return NULL;
+
+    if (!(sourceEntry = calcSourceManagerAdd(sourceManager, path, cleanupPath, sourceBuffer)))
+        calcDeleteSourceBuffer(sourceBuffer);
+
+    return sourceEntry;
+}
+
+CALC_API CalcSourceStream_t *CALC_STDCALL calcSourceManagerCreateStream(const CalcSourceEntry_t *const sourceEntry)
+{
+    return calcCreateSourceStreamFromBuffer(sourceEntry->path, sourceEntry->buffer, sourceEntry->base);
+}
+
+CALC_API CalcSourceEntry_t *CALC_STDCALL calcSourceManagerFind(const CalcSourceManager_t *const sourceManager, CalcSourceLoc_t sourceLoc, size_t *const outOffset)
+{
+    size_t lo = 0, hi = sourceManager->count, mid;
+    CalcSourceEntry_t *sourceEntry;
+
+    if ((sourceLoc == CALC_SOURCE_INVALID_LOC) || (sourceLoc >= sourceManager->next))
+        return NULL;
+
+    // Looks for the last entry whose base is at or before the location.
+    while ((hi - lo) > 1)
+    {
+        mid = lo + ((hi - lo) >> 1);
+
+        if (sourceManager->entries[mid]->base <= sourceLoc)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    sourceEntry = sourceManager->entries[lo];
+
+    if (outOffset)
+        *outOffset = (size_t)(sourceLoc - sourceEntry->base);
+
+    return sourceEntry;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourceManagerDecode(const CalcSourceManager_t *const sourceManager, CalcSourceLoc_t sourceLoc, const char **const outPath, CalcSourceLine_t *const outLine)
+{
+    CalcSourceEntry_t *sourceEntry;
+    size_t offset;
+
+    if (!(sourceEntry = calcSourceManagerFind(sourceManager, sourceLoc, &offset)))
+        return FALSE;
+
+    if (outPath)
+        *outPath = sourceEntry->path;
+
+    return calcSourceBufferFindLine(sourceEntry->buffer, offset, outLine);
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourceManager(CalcSourceManager_t *const sourceManager)
+{
+    size_t i;
+
+    for (i = 0; i < sourceManager->count; i++)
+    {
+        calcDeleteSourceBuffer(sourceManager->entries[i]->buffer);
+
+        if (sourceManager->entries[i]->cleanup)
+            free(sourceManager->entries[i]->path);
+
+        free(sourceManager->entries[i]);
+    }
+
+    free(sourceManager->entries);
+    free(sourceManager);
+
+    return;
+}
@@ -0,0 +1,306 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+
+#include "calc/source/source_piece_table.h"
+
+#define CALC_SOURCE_PIECE_TABLE_CAPACITY 16
+
+static inline const byte_t *CALC_STDCALL calc_GetSourcePieceData(const CalcSourcePieceTable_t *const sourcePieceTable, const CalcSourcePiece_t *const sourcePiece)
+{
+    return (sourcePiece->isAdded ? sourcePieceTable->added : sourcePieceTable->original->data) + sourcePiece->offset;
+}
+
+static CalcSourcePiece_t *CALC_STDCALL calc_InsertSourcePieces(CalcSourcePieceTable_t *const sourcePieceTable, size_t index, size_t count)
+{
+    if ((sourcePieceTable->count + count) > sourcePieceTable->capacity)
+    {
+        while ((sourcePieceTable->count + count) > sourcePieceTable->capacity)
+            sourcePieceTable->capacity <<= 1;
+
+        sourcePieceTable->pieces = redim(CalcSourcePiece_t, sourcePieceTable->pieces, sourcePieceTable->capacity);
+    }
+
+    memmove(sourcePieceTable->pieces + index + count, sourcePieceTable->pieces + index, (sourcePieceTable->count - index) * sizeof(CalcSourcePiece_t));
+    sourcePieceTable->count += count;
+
+    return sourcePieceTable->pieces + index;
+}
+
+/// @brief Splits the pieces of a table at an offset of the content.
+/// @return The index of the piece that starts at the offset, or the number of
+///         pieces if the offset is the end of the content.
+static size_t CALC_STDCALL calc_SplitSourcePieces(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset)
+{
+    CalcSourcePiece_t *sourcePiece;
+    size_t i, position = 0;
+
+    for (i = 0; i < sourcePieceTable->count; i++)
+    {
+        if (offset == position)
+            return i;
+
+        if (offset < (position + sourcePieceTable->pieces[i].length))
+            break;
+
+        position += sourcePieceTable->pieces[i].length;
+    }
+
+    if (i == sourcePieceTable->count)
+        return i;
+
+    sourcePiece = calc_InsertSourcePieces(sourcePieceTable, i + 1, 1) - 1;
+
+    sourcePiece[1].isAdded = sourcePiece[0].isAdded;
+    sourcePiece[1].offset = sourcePiece[0].offset + (offset - position);
+    sourcePiece[1].length = sourcePiece[0].length - (offset - position);
+    sourcePiece[0].length = offset - position;
+
+    return i + 1;
+}
+
+/// @brief Extends the changed range of a table with an edit that replaced the
+///        bytes [offset, offset + deleted) with inserted bytes.
+static void CALC_STDCALL calc_ChangeSourcePieceTable(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, size_t deleted, size_t inserted)
+{
+    CalcSourceRange_t *range = &sourcePieceTable->changed;
+    size_t end = offset + deleted;
+
+    if (!sourcePieceTable->isChanged)
+    {
+        range->begin = offset;
+        range->end = offset + inserted;
+        sourcePieceTable->isChanged = TRUE;
+
+        return;
+    }
+
+    // The bounds of the previous range are moved to the offsets of the new
+    // content: the ones in the replaced bytes collapse to the edit.
+    if (range->begin >= end)
+        range->begin = range->begin - deleted + inserted;
+    else if (range->begin > offset)
+        range->begin = offset;
+
+    if (range->end >= end)
+        range->end = range->end - deleted + inserted;
+    else if (range->end > offset)
+        range->end = offset + inserted;
+
+    range->begin = min(range->begin, offset);
+    range->end = max(range->end, offset + inserted);
+}
+
+static size_t CALC_STDCALL calc_ReadSourcePieceTable(void *context, byte_t *buffer, size_t count)
+{
+    CalcSourcePieceTable_t *sourcePieceTable = (CalcSourcePieceTable_t *)context;
+    const CalcSourcePiece_t *sourcePiece;
+    size_t length = 0, n;
+
+    while ((length < count) && (sourcePieceTable->cursorPiece < sourcePieceTable->count))
+    {
+        sourcePiece = sourcePieceTable->pieces + sourcePieceTable->cursorPiece;
+        n = min(count - length, sourcePiece->length - sourcePieceTable->cursorOffset);
+
+        bufcpy(buffer + length, calc_GetSourcePieceData(sourcePieceTable, sourcePiece) + sourcePieceTable->cursorOffset, n);
+        length += n;
+
+        if ((sourcePieceTable->cursorOffset += n) == sourcePiece->length)
+            sourcePieceTable->cursorPiece++, sourcePieceTable->cursorOffset = 0;
+    }
+
+    return length;
+}
+
+CALC_API CalcSourcePieceTable_t *CALC_STDCALL calcCreateSourcePieceTable(CalcSourceBuffer_t *const sourceBuffer)
+{
+    assert(sourceBuffer != NULL);
+
+    CalcSourcePieceTable_t *sourcePieceTable = alloc(CalcSourcePieceTable_t);
+
+    sourcePieceTable->original = sourceBuffer;
+    sourcePieceTable->added = NULL;
+    sourcePieceTable->addedCount = 0;
+    sourcePieceTable->addedCapacity = 0;
+    sourcePieceTable->pieces = dim(CalcSourcePiece_t, CALC_SOURCE_PIECE_TABLE_CAPACITY);
+    sourcePieceTable->count = 0;
+    sourcePieceTable->capacity = CALC_SOURCE_PIECE_TABLE_CAPACITY;
+    // The NUL sentinel of the original buffer is not part of the content.
+    sourcePieceTable->length = sourceBuffer->size ? (sourceBuffer->size - 1) : 0;
+    sourcePieceTable->isChanged = FALSE;
+    sourcePieceTable->changed.begin = 0;
+    sourcePieceTable->changed.end = 0;
+    sourcePieceTable->cursorPiece = 0;
+    sourcePieceTable->cursorOffset = 0;
+
+    if (sourcePieceTable->length)
+    {
+        sourcePieceTable->pieces[0].isAdded = FALSE;
+        sourcePieceTable->pieces[0].offset = 0;
+        sourcePieceTable->pieces[0].length = sourcePieceTable->length;
+        sourcePieceTable->count = 1;
+    }
+
+    return sourcePieceTable;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourcePieceTableInsert(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, const byte_t *const text, size_t count)
+{
+    CalcSourcePiece_t *sourcePiece;
+    size_t index;
+
+    if (offset > sourcePieceTable->length)
+        return FALSE;
+
+    if (!count)
+        return TRUE;
+
+    if ((sourcePieceTable->addedCount + count) > sourcePieceTable->addedCapacity)
+    {
+        sourcePieceTable->addedCapacity = max(sourcePieceTable->addedCapacity << 1, sourcePieceTable->addedCount + count);
+        sourcePieceTable->added = redim(byte_t, sourcePieceTable->added, sourcePieceTable->addedCapacity);
+    }
+
+    index = calc_SplitSourcePieces(sourcePieceTable, offset);
+    sourcePiece = index ? (sourcePieceTable->pieces + index - 1) : NULL;
+
+    // Bytes typed after the last inserted ones extend their piece instead of
+    // adding a new one.
+    if (sourcePiece && sourcePiece->isAdded && ((sourcePiece->offset + sourcePiece->length) == sourcePieceTable->addedCount))
+    {
+        sourcePiece->length += count;
+    }
+    else
+    {
+        sourcePiece = calc_InsertSourcePieces(sourcePieceTable, index, 1);
+
+        sourcePiece->isAdded = TRUE;
+        sourcePiece->offset = sourcePieceTable->addedCount;
+        sourcePiece->length = count;
+    }
+
+    bufcpy(sourcePieceTable->added + sourcePieceTable->addedCount, text, count);
+    sourcePieceTable->addedCount += count;
+    sourcePieceTable->length += count;
+
+    calc_ChangeSourcePieceTable(sourcePieceTable, offset, 0, count);
+
+    return TRUE;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourcePieceTableDelete(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, size_t count)
+{
+    size_t first, last;
+
+    if ((offset > sourcePieceTable->length) || (count > (sourcePieceTable->length - offset)))
+        return FALSE;
+
+    if (!count)
+        return TRUE;
+
+    first = calc_SplitSourcePieces(sourcePieceTable, offset);
+    last = calc_SplitSourcePieces(sourcePieceTable, offset + count);
+
+    memmove(sourcePieceTable->pieces + first, sourcePieceTable->pieces + last, (sourcePieceTable->count - last) * sizeof(CalcSourcePiece_t));
+    sourcePieceTable->count -= last - first;
+    sourcePieceTable->length -= count;
+
+    calc_ChangeSourcePieceTable(sourcePieceTable, offset, count, 0);
+
+    return TRUE;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourcePieceTableTakeChanges(CalcSourcePieceTable_t *const sourcePieceTable, CalcSourceRange_t *const outRange)
+{
+    bool_t isChanged = sourcePieceTable->isChanged;
+
+    if (outRange)
+        *outRange = sourcePieceTable->changed;
+
+    sourcePieceTable->isChanged = FALSE;
+    sourcePieceTable->changed.begin = 0;
+    sourcePieceTable->changed.end = 0;
+
+    return isChanged;
+}
+
+CALC_API size_t CALC_STDCALL calcSourcePieceTableGetSpan(const CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, CalcSourceSpan_t *const outSpan)
+{
+    const CalcSourcePiece_t *sourcePiece;
+    size_t i, position = 0;
+
+    outSpan->data = NULL;
+    outSpan->length = 0;
+
+    for (i = 0; i < sourcePieceTable->count; i++)
+    {
+        sourcePiece = sourcePieceTable->pieces + i;
+
+        if (offset < (position + sourcePiece->length))
+        {
+            outSpan->data = calc_GetSourcePieceData(sourcePieceTable, sourcePiece) + (offset - position);
+            outSpan->length = sourcePiece->length - (offset - position);
+            break;
+        }
+
+        position += sourcePiece->length;
+    }
+
+    return outSpan->length;
+}
+
+CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenSourceStreamFromPieceTable(CalcSourcePieceTable_t *const sourcePieceTable, size_t offset, CalcSourceEncoding_t encoding)
+{
+    size_t i, position = 0;
+
+    if (offset > sourcePieceTable->length)
+        return NULL;
+
+    for (i = 0; (i < sourcePieceTable->count) && (offset >= (position + sourcePieceTable->pieces[i].length)); i++)
+        position += sourcePieceTable->pieces[i].length;
+
+    sourcePieceTable->cursorPiece = i;
+    sourcePieceTable->cursorOffset = offset - position;
+
+    return calcOpenSourceStreamFromReader(NULL, calc_ReadSourcePieceTable, sourcePieceTable, encoding);
+}
+
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreateSourceBufferFromPieceTable(const CalcSourcePieceTable_t *const sourcePieceTable)
+{
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBuffer(sourcePieceTable->length + 1, NULL, 0);
+    const CalcSourcePiece_t *sourcePiece;
+    size_t i, position = 0;
+
+    for (i = 0; i < sourcePieceTable->count; i++)
+    {
+        sourcePiece = sourcePieceTable->pieces + i;
+
+        bufcpy(sourceBuffer->data + position, calc_GetSourcePieceData(sourcePieceTable, sourcePiece), sourcePiece->length);
+        position += sourcePiece->length;
+    }
+
+    sourceBuffer->data[position] = NUL;
+    sourceBuffer->encoding = sourcePieceTable->original->encoding;
+
+    calcValidateSourceBuffer(sourceBuffer);
+
+    return sourceBuffer;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourcePieceTable(CalcSourcePieceTable_t *const sourcePieceTable)
+{
+    calcDeleteSourceBuffer(sourcePieceTable->original);
+
+    if (sourcePieceTable->added)
+        free(sourcePieceTable->added);
+
+    free(sourcePieceTable->pieces);
+    free(sourcePieceTable);
+
+    return;
+}
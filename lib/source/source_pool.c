@@ -0,0 +1,175 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+
+#include "calc/source/source_lines.h"
+#include "calc/source/source_pool.h"
+
+CALC_API CalcSourcePool_t *CALC_STDCALL calcCreateSourcePool(void)
+{
+    CalcSourcePool_t *sourcePool = alloc(CalcSourcePool_t);
+    size_t i;
+
+    for (i = 0; i < CALC_SOURCE_POOL_CLASSES; i++)
+        sourcePool->bufferCounts[i] = 0;
+
+    sourcePool->streamCount = 0;
+    sourcePool->allocations = 0;
+    sourcePool->reuses = 0;
+    sourcePool->releases = 0;
+
+    return sourcePool;
+}
+
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcSourcePoolAcquireBuffer(CalcSourcePool_t *const sourcePool, size_t size)
+{
+    CalcSourceBuffer_t *sourceBuffer;
+    size_t sizeClass = 0, capacity = CALC_SOURCE_POOL_MIN_SIZE;
+
+    // The smallest class whose buffers can store the bytes.
+    while ((capacity < size) && (sizeClass < CALC_SOURCE_POOL_CLASSES))
+        capacity <<= 1, sizeClass++;
+
+    if ((sizeClass < CALC_SOURCE_POOL_CLASSES) && sourcePool->bufferCounts[sizeClass])
+    {
+        sourceBuffer = sourcePool->buffers[sizeClass][--sourcePool->bufferCounts[sizeClass]];
+        sourcePool->reuses++;
+    }
+    else
+    {
+        if (sizeClass == CALC_SOURCE_POOL_CLASSES)
+            capacity = size;
+
+        sourceBuffer = alloc(CalcSourceBuffer_t);
+        sourceBuffer->data = (byte_t *)cmalloc(capacity);
+        sourceBuffer->capacity = capacity;
+        sourcePool->allocations++;
+    }
+
+    sourceBuffer->size = size;
+    sourceBuffer->isMapped = FALSE;
+    sourceBuffer->isValidated = FALSE;
+    sourceBuffer->invalidOffset = 0;
+    sourceBuffer->lines = NULL;
+    sourceBuffer->encoding = CALC_SOURCE_ENCODING_UTF_8;
+
+    return sourceBuffer;
+}
+
+CALC_API void CALC_STDCALL calcSourcePoolReleaseBuffer(CalcSourcePool_t *const sourcePool, CalcSourceBuffer_t *const sourceBuffer)
+{
+    size_t sizeClass = 0, capacity = CALC_SOURCE_POOL_MIN_SIZE;
+
+    if (sourceBuffer->isMapped || (sourceBuffer->capacity < CALC_SOURCE_POOL_MIN_SIZE) || (sourceBuffer->capacity >= ((size_t)CALC_SOURCE_POOL_MIN_SIZE << CALC_SOURCE_POOL_CLASSES)))
+    {
+        calcDeleteSourceBuffer(sourceBuffer);
+        return;
+    }
+
+    // The largest class whose size the buffer can store: buffers that were
+    // reallocated (e.g. by transcoding) are still recycled.
+    while (((capacity << 1) <= sourceBuffer->capacity) && ((sizeClass + 1) < CALC_SOURCE_POOL_CLASSES))
+        capacity <<= 1, sizeClass++;
+
+    if (sourcePool->bufferCounts[sizeClass] == CALC_SOURCE_POOL_LIMIT)
+    {
+        calcDeleteSourceBuffer(sourceBuffer);
+        return;
+    }
+
+    if (sourceBuffer->lines)
+    {
+        calcDeleteSourceLines(sourceBuffer->lines);
+        sourceBuffer->lines = NULL;
+    }
+
+    sourcePool->buffers[sizeClass][sourcePool->bufferCounts[sizeClass]++] = sourceBuffer;
+    sourcePool->releases++;
+
+    return;
+}
+
+CALC_API void *CALC_STDCALL calcSourcePoolAcquireStream(CalcSourcePool_t *const sourcePool, size_t size)
+{
+    if (sourcePool->streamCount)
+        return sourcePool->reuses++, sourcePool->streams[--sourcePool->streamCount];
+    else
+        return sourcePool->allocations++, cmalloc(size);
+}
+
+CALC_API void CALC_STDCALL calcSourcePoolReleaseStream(CalcSourcePool_t *const sourcePool, void *const sourceStream)
+{
+    if (sourcePool->streamCount == CALC_SOURCE_POOL_LIMIT)
+    {
+        free(sourceStream);
+        return;
+    }
+
+    sourcePool->streams[sourcePool->streamCount++] = sourceStream;
+    sourcePool->releases++;
+
+    return;
+}
+
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreatePooledSourceBufferFromText(CalcSourcePool_t *const sourcePool, const char *const text)
+{
+    size_t length = text ? strlen(text) : 0;
+    CalcSourceBuffer_t *sourceBuffer = calcSourcePoolAcquireBuffer(sourcePool, length + 1);
+
+    bufcpy(sourceBuffer->data, (const byte_t *)text, length);
+    sourceBuffer->data[length] = NUL;
+
+    calcValidateSourceBuffer(sourceBuffer);
+
+    return sourceBuffer;
+}
+
+CALC_API CalcSourceBuffer_t *CALC_STDCALL calcCreatePooledSourceBufferFromFile(CalcSourcePool_t *const sourcePool, const char *const path, CalcSourceEncoding_t encoding)
+{
+    assert(path != NULL);
+
+    CalcSourceBuffer_t *sourceBuffer;
+    FILE *stream;
+    size_t size, fpos = 0, count;
+
+    if (!(stream = fopen(path, CALC_LOADMOD)))
+        return NULL;
+
+    size = fgetsiz(stream);
+    sourceBuffer = calcSourcePoolAcquireBuffer(sourcePool, size + 1);
+
+    while ((fpos < size) && ((count = fread(sourceBuffer->data + fpos, sizeof(byte_t), size - fpos, stream)) != 0))
+        fpos += count;
+
+    fclose(stream);
+
+    sourceBuffer->data[fpos] = NUL;
+    sourceBuffer->size = fpos + 1;
+
+    calcTranscodeSourceBuffer(sourceBuffer, encoding);
+
+    return sourceBuffer;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourcePool(CalcSourcePool_t *const sourcePool)
+{
+    size_t i;
+
+    for (i = 0; i < CALC_SOURCE_POOL_CLASSES; i++)
+    {
+        while (sourcePool->bufferCounts[i])
+            calcDeleteSourceBuffer(sourcePool->buffers[i][--sourcePool->bufferCounts[i]]);
+    }
+
+    while (sourcePool->streamCount)
+        free(sourcePool->streams[--sourcePool->streamCount]);
+
+    free(sourcePool);
+
+    return;
+}
@@ -0,0 +1,159 @@
+/**
+ * This file is part of the calc scripting language project,
+ * under the Apache License v2.0. See LICENSE for license
+ * informations.
+ */
+
+#include "calc/base/alloc.h"
+#include "calc/base/thread.h"
+#include "calc/base/utils.h"
+
+#include "calc/source/source_prefetcher.h"
+
+static void CALC_STDCALL calc_SourcePrefetcherRun(void *arg)
+{
+    CalcSourcePrefetcher_t *sourcePrefetcher = (CalcSourcePrefetcher_t *)arg;
+    CalcSourceSegment_t *segment;
+    size_t count;
+
+    mtxlock(sourcePrefetcher->mutex);
+
+    while (!sourcePrefetcher->isExhausted)
+    {
+        while (!sourcePrefetcher->isStopped && ((sourcePrefetcher->head - sourcePrefetcher->tail) == sourcePrefetcher->segmentCount))
+            cndwait(sourcePrefetcher->emptied, sourcePrefetcher->mutex);
+
+        if (sourcePrefetcher->isStopped)
+            break;
+
+        segment = &sourcePrefetcher->segments[sourcePrefetcher->head % sourcePrefetcher->segmentCount];
+
+        // The segment at the head belongs to this thread until it's filled,
+        // so the file stream is read without holding the lock.
+        mtxunlock(sourcePrefetcher->mutex);
+        count = fread((void *)segment->data, sizeof(byte_t), sourcePrefetcher->segmentSize, sourcePrefetcher->stream);
+        mtxlock(sourcePrefetcher->mutex);
+
+        segment->count = count;
+
+        if (count < sourcePrefetcher->segmentSize)
+            sourcePrefetcher->isExhausted = TRUE;
+
+        if (count)
+            sourcePrefetcher->head++;
+
+        cndsignal(sourcePrefetcher->filled);
+    }
+
+    mtxunlock(sourcePrefetcher->mutex);
+
+    return;
+}
+
+CALC_API CalcSourcePrefetcher_t *CALC_STDCALL calcCreateSourcePrefetcher(FILE *const stream, size_t segmentSize, size_t segmentCount)
+{
+    assert(stream != NULL);
+
+    CalcSourcePrefetcher_t *sourcePrefetcher = alloc(CalcSourcePrefetcher_t);
+    size_t i;
+
+    if (!segmentCount)
+        segmentCount = CALC_SOURCE_PREFETCHER_SEGMENTS;
+
+    sourcePrefetcher->stream = stream;
+    sourcePrefetcher->mutex = mtxcreate();
+    sourcePrefetcher->filled = cndcreate();
+    sourcePrefetcher->emptied = cndcreate();
+    sourcePrefetcher->segments = dim(CalcSourceSegment_t, segmentCount);
+    sourcePrefetcher->segmentCount = segmentCount;
+    sourcePrefetcher->segmentSize = segmentSize;
+    sourcePrefetcher->head = 0;
+    sourcePrefetcher->tail = 0;
+    sourcePrefetcher->offset = 0;
+    sourcePrefetcher->isExhausted = FALSE;
+    sourcePrefetcher->isStopped = FALSE;
+
+    for (i = 0; i < segmentCount; i++)
+        sourcePrefetcher->segments[i].data = (byte_t *)cmalloc(segmentSize);
+
+    if (!(sourcePrefetcher->thread = thrdspawn(calc_SourcePrefetcherRun, (void *)sourcePrefetcher)))
+    {
+        sourcePrefetcher->isStopped = TRUE;
+        calcDeleteSourcePrefetcher(sourcePrefetcher);
+
+        return NULL;
+    }
+
+    return sourcePrefetcher;
+}
+
+CALC_API size_t CALC_STDCALL calcSourcePrefetcherRead(CalcSourcePrefetcher_t *const sourcePrefetcher, byte_t *const buffer, size_t count)
+{
+    CalcSourceSegment_t *segment;
+    size_t total = 0, chunk;
+
+    mtxlock(sourcePrefetcher->mutex);
+
+    while (total < count)
+    {
+        while ((sourcePrefetcher->head == sourcePrefetcher->tail) && !sourcePrefetcher->isExhausted)
+            cndwait(sourcePrefetcher->filled, sourcePrefetcher->mutex);
+
+        if (sourcePrefetcher->head == sourcePrefetcher->tail)
+            break;
+
+        segment = &sourcePrefetcher->segments[sourcePrefetcher->tail % sourcePrefetcher->segmentCount];
+
+        // The segment at the tail belongs to this thread until it's emptied,
+        // so its bytes are copied without holding the lock.
+        mtxunlock(sourcePrefetcher->mutex);
+
+        chunk = min(count - total, segment->count - sourcePrefetcher->offset);
+        bufcpy(buffer + total, segment->data + sourcePrefetcher->offset, chunk);
+
+        total += chunk;
+        sourcePrefetcher->offset += chunk;
+
+        mtxlock(sourcePrefetcher->mutex);
+
+        if (sourcePrefetcher->offset == segment->count)
+        {
+            sourcePrefetcher->offset = 0;
+            sourcePrefetcher->tail++;
+
+            cndsignal(sourcePrefetcher->emptied);
+        }
+    }
+
+    mtxunlock(sourcePrefetcher->mutex);
+
+    return total;
+}
+
+CALC_API void CALC_STDCALL calcDeleteSourcePrefetcher(CalcSourcePrefetcher_t *const sourcePrefetcher)
+{
+    size_t i;
+
+    if (sourcePrefetcher->thread)
+    {
+        mtxlock(sourcePrefetcher->mutex);
+        sourcePrefetcher->isStopped = TRUE;
+        cndsignal(sourcePrefetcher->emptied);
+        mtxunlock(sourcePrefetcher->mutex);
+
+        thrdjoin(sourcePrefetcher->thread);
+    }
+
+    for (i = 0; i < sourcePrefetcher->segmentCount; i++)
+        free(sourcePrefetcher->segments[i].data);
+
+    free(sourcePrefetcher->segments);
+
+    cnddelete(sourcePrefetcher->emptied);
+    cnddelete(sourcePrefetcher->filled);
+    mtxdelete(sourcePrefetcher->mutex);
+
+    free(sourcePrefetcher);
+
+    return;
+}
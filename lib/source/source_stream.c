@@ -5,159 +5,705 @@
  */
 
 #include "calc/base/alloc.h"
+#include "calc/base/scan.h"
+#include "calc/base/string.h"
+#include "calc/base/utf8.h"
+#include "calc/base/utils.h"
 
+#include "calc/source/source_lines.h"
 #include "calc/source/source_stream.h"
 
+static const CalcSourceDecoder_t *CALC_STDCALL calc_GetSourceDecoder(CalcSourceEncoding_t encoding);
+static void CALC_STDCALL calc_SourceStreamSelect(CalcSourceStream_t *const sourceStream);
+
 static inline CalcSourceStream_t *CALC_STDCALL calc_InitializeSourceStream(CalcSourceStream_t *const sourceStream)
 {
     sourceStream->path = NULL;
     sourceStream->stream = NULL;
+    sourceStream->reader = NULL;
+    sourceStream->readerContext = NULL;
 
     sourceStream->isStdin = FALSE;
+    sourceStream->isInteractive = FALSE;
     sourceStream->isInitialized = FALSE;
     sourceStream->isOpen = FALSE;
     sourceStream->cleanup = FALSE;
+    sourceStream->pool = NULL;
 
+    sourceStream->decoder = calc_GetSourceDecoder(sourceStream->encoding = CALC_DEFAULT_ENCODING);
     sourceStream->buffer = NULL;
+    sourceStream->isShared = FALSE;
+    sourceStream->base = CALC_SOURCE_INVALID_LOC + 1;
+    sourceStream->bufferMask = UINT64_MAX;
+    sourceStream->bufferEnd = 0;
+    sourceStream->asciiBegin = 0;
+    sourceStream->asciiEnd = 0;
+    sourceStream->refillSize = CALC_SOURCE_STREAM_REFILL_SIZE;
+    sourceStream->memoryBudget = 0;
+    sourceStream->isOverflowed = FALSE;
+    sourceStream->isLexing = FALSE;
+    sourceStream->prefetcher = NULL;
+    sourceStream->lookaheadHead = 0;
+    sourceStream->lookaheadCount = 0;
+    sourceStream->lookaheadEnd = 0;
 
     calcResetSourceLocation(&sourceStream->streamLocation);
     calcResetSourceLocation(&sourceStream->beginLocation);
     calcResetSourceLocation(&sourceStream->forwardLocation);
 
+    sourceStream->isLazy = FALSE;
+    calcResetSourceLocation(&sourceStream->anchorLocation);
+    sourceStream->checkpointCount = 0;
+    sourceStream->checkpointPosition = 0;
+
+    calc_SourceStreamSelect(sourceStream);
+
     return sourceStream;
 }
 
-static inline CalcSourceStream_t *CALC_STDCALL calc_CreateSourceStream(const char *const path, FILE *const stream, bool_t isStdin, bool_t isInitialized, bool_t isOpen, bool_t cleanup, CalcSourceEncoding_t encoding, CalcSourceBuffer_t *const sourceBuffer)
+static inline CalcSourceStream_t *CALC_STDCALL calc_CreateSourceStream(const char *const path, FILE *const stream, bool_t isStdin, bool_t isInitialized, bool_t isOpen, bool_t cleanup, CalcSourceEncoding_t encoding, CalcSourceBuffer_t *const sourceBuffer, CalcSourcePool_t *const sourcePool)
 {
-    CalcSourceStream_t *sourceStream = alloc(CalcSourceStream_t);
+    CalcSourceStream_t *sourceStream = !sourcePool ? alloc(CalcSourceStream_t) : (CalcSourceStream_t *)calcSourcePoolAcquireStream(sourcePool, sizeof(CalcSourceStream_t));
 
     sourceStream->path = (char *)path;
     sourceStream->stream = stream;
+    sourceStream->reader = NULL;
+    sourceStream->readerContext = NULL;
 
     sourceStream->isStdin = isStdin;
+    sourceStream->isInteractive = (bool_t)(isStdin && fisatty(stream));
     sourceStream->isInitialized = isInitialized;
     sourceStream->isOpen = isOpen;
     sourceStream->cleanup = cleanup;
+    sourceStream->pool = sourcePool;
 
-    sourceStream->encoding = encoding;
+    sourceStream->decoder = calc_GetSourceDecoder(encoding);
+    sourceStream->encoding = sourceStream->decoder->encoding;
     sourceStream->buffer = sourceBuffer;
+    sourceStream->isShared = FALSE;
+    sourceStream->base = CALC_SOURCE_INVALID_LOC + 1;
+    sourceStream->asciiBegin = 0;
+    sourceStream->asciiEnd = 0;
+    sourceStream->refillSize = CALC_SOURCE_STREAM_REFILL_SIZE;
+    sourceStream->memoryBudget = 0;
+    sourceStream->isOverflowed = FALSE;
+    sourceStream->isLexing = FALSE;
+    sourceStream->prefetcher = NULL;
+    sourceStream->lookaheadHead = 0;
+    sourceStream->lookaheadCount = 0;
+    sourceStream->lookaheadEnd = 0;
+
+    if (!isOpen)
+    {
+        // The whole content is alredy in the buffer: positions are indices.
+        sourceStream->bufferMask = UINT64_MAX;
+        sourceStream->bufferEnd = sourceBuffer->size;
+    }
+    else
+    {
+        // The buffer stores two copies of a ring of half its size.
+        sourceStream->bufferMask = (sourceBuffer->size >> 1) - 1;
+        sourceStream->bufferEnd = 0;
+    }
 
     calcResetSourceLocation(&sourceStream->streamLocation);
     calcResetSourceLocation(&sourceStream->beginLocation);
     calcResetSourceLocation(&sourceStream->forwardLocation);
 
+    sourceStream->isLazy = FALSE;
+    calcResetSourceLocation(&sourceStream->anchorLocation);
+    sourceStream->checkpointCount = 0;
+    sourceStream->checkpointPosition = 0;
+
+    calc_SourceStreamSelect(sourceStream);
+
     return sourceStream;
 }
 
+/// @brief Gets the encoding in which a stream reads a whole source buffer:
+///        transcoded buffers always store UTF-8 characters.
+static inline CalcSourceEncoding_t CALC_STDCALL calc_SourceStreamEncoding(const CalcSourceBuffer_t *const sourceBuffer)
+{
+    if (sourceBuffer->encoding == CALC_SOURCE_ENCODING_ASCII)
+        return CALC_SOURCE_ENCODING_ASCII;
+    else
+        return CALC_SOURCE_ENCODING_UTF_8;
+}
+
+static inline CalcSourceBuffer_t *CALC_STDCALL calc_CreateSourceStreamRing(size_t capacity)
+{
+    return calcCreateSourceBuffer(capacity << 1, NULL, 0);
+}
+
+/// @brief Gets the number of columns spanned by a sequence of bytes, that are
+///        its characters.
+static inline uint64_t CALC_STDCALL calc_SourceStreamColumns(const CalcSourceStream_t *const sourceStream, const byte_t *const data, size_t length)
+{
+    if (sourceStream->encoding == CALC_SOURCE_ENCODING_ASCII)
+        return (uint64_t)length;
+    else
+        return (uint64_t)bufchars(data, length);
+}
+
+/// @brief Advances the line and the column of a location over a sequence of
+///        bytes, its byte offset is left to the caller.
+static inline void CALC_STDCALL calc_SourceStreamCount(const CalcSourceStream_t *const sourceStream, CalcSourceLocation_t *const sourceLocation, const byte_t *const data, size_t length)
+{
+    const byte_t *p, *end = data + length;
+    size_t lines;
+
+    // Short spans, as most of the lexemes, are cheaper to count inline.
+    if (length < CALC_SOURCE_STREAM_SHORT_SPAN)
+    {
+        for (p = data; p < end; p++)
+        {
+            if (*p == EOL)
+                sourceLocation->ln++, sourceLocation->co = 0;
+            else if ((sourceStream->encoding == CALC_SOURCE_ENCODING_ASCII) || ((*p & 0xC0) != 0x80))
+                sourceLocation->co++;
+        }
+
+        return;
+    }
+
+    lines = bufcount(data, length, EOL);
+
+    if (lines)
+    {
+        // The column restarts after the last EOL.
+        for (p = end; p[-1] != EOL; p--)
+            ;
+
+        sourceLocation->ln += lines;
+        sourceLocation->co = calc_SourceStreamColumns(sourceStream, p, (size_t)(end - p));
+    }
+    else
+    {
+        sourceLocation->co += calc_SourceStreamColumns(sourceStream, data, length);
+    }
+
+    return;
+}
+
 CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromText(const char *const text, CalcSourceEncoding_t encoding)
 {
-    return calc_CreateSourceStream(NULL, NULL, FALSE, FALSE, FALSE, FALSE, encoding, calcCreateSourceBufferFromText(text));
+    return calc_CreateSourceStream(NULL, NULL, FALSE, FALSE, FALSE, FALSE, encoding, calcCreateSourceBufferFromText(text), NULL);
 }
 
 CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromFile(const char *const path, bool_t cleanupPath, CalcSourceEncoding_t encoding)
 {
     assert(path != NULL);
 
-    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBufferFromFile(path);
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBufferFromFile(path, encoding);
 
     if (!sourceBuffer)
         return NULL;
     else
-        return calc_CreateSourceStream(path, NULL, FALSE, FALSE, FALSE, cleanupPath, encoding, sourceBuffer);
+        return calc_CreateSourceStream(path, NULL, FALSE, FALSE, FALSE, cleanupPath, calc_SourceStreamEncoding(sourceBuffer), sourceBuffer, NULL);
 }
 
 CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromStream(FILE *const stream, CalcSourceEncoding_t encoding)
 {
     assert(stream != NULL);
 
-    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBufferFromStream(stream);
+    CalcSourceBuffer_t *sourceBuffer = calcCreateSourceBufferFromStream(stream, encoding);
 
     if (!sourceBuffer)
         return NULL;
     else
-        return calc_CreateSourceStream(NULL, NULL, FALSE, FALSE, FALSE, FALSE, encoding, sourceBuffer);
+        return calc_CreateSourceStream(NULL, NULL, FALSE, FALSE, FALSE, FALSE, calc_SourceStreamEncoding(sourceBuffer), sourceBuffer, NULL);
+}
+
+CALC_API CalcSourceStream_t *CALC_STDCALL calcCreateSourceStreamFromBuffer(const char *const path, CalcSourceBuffer_t *const sourceBuffer, CalcSourceLoc_t base)
+{
+    assert(sourceBuffer != NULL);
+
+    CalcSourceStream_t *sourceStream = calc_CreateSourceStream(path, NULL, FALSE, FALSE, FALSE, FALSE, calc_SourceStreamEncoding(sourceBuffer), sourceBuffer, NULL);
+
+    sourceStream->isShared = TRUE;
+    sourceStream->base = base;
+
+    return sourceStream;
+}
+
+CALC_API CalcSourceStream_t *CALC_STDCALL calcCreatePooledSourceStreamFromText(CalcSourcePool_t *const sourcePool, const char *const text, CalcSourceEncoding_t encoding)
+{
+    return calc_CreateSourceStream(NULL, NULL, FALSE, FALSE, FALSE, FALSE, encoding, calcCreatePooledSourceBufferFromText(sourcePool, text), sourcePool);
+}
+
+CALC_API CalcSourceStream_t *CALC_STDCALL calcCreatePooledSourceStreamFromFile(CalcSourcePool_t *const sourcePool, const char *const path, bool_t cleanupPath, CalcSourceEncoding_t encoding)
+{
+    assert(path != NULL);
+
+    CalcSourceBuffer_t *sourceBuffer = calcCreatePooledSourceBufferFromFile(sourcePool, path, encoding);
+
+    if (!sourceBuffer)
+        return NULL;
+    else
+        return calc_CreateSourceStream(path, NULL, FALSE, FALSE, FALSE, cleanupPath, calc_SourceStreamEncoding(sourceBuffer), sourceBuffer, sourcePool);
 }
 
 CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenSourceStream(const char *const path, bool_t cleanupPath, CalcSourceEncoding_t encoding)
 {
     assert(path != NULL);
 
+    // Sources that must be transcoded are loaded whole, so the ring only
+    // ever stores ASCII or UTF-8 characters.
+    if ((encoding == CALC_SOURCE_ENCODING_LATIN_1) || (encoding == CALC_SOURCE_ENCODING_UTF_16LE))
+        return calcCreateSourceStreamFromFile(path, cleanupPath, encoding);
+
     FILE *stream = fopen(path, CALC_LOADMOD);
+    CalcSourceStream_t *sourceStream;
+    byte_t bom[3];
+    size_t count;
 
     if (!stream)
         return NULL;
 
-    return calc_CreateSourceStream(path, stream, FALSE, FALSE, TRUE, cleanupPath, encoding, calcCreateSourceBuffer(CALC_PAGESIZ, NULL, 0));
+    // The BOM is sniffed by the first refill, that reads at most its bytes: a
+    // BOM takes precedence over the declared encoding.
+    count = fread((void *)bom, sizeof(byte_t), sizeof(bom), stream);
+
+    if ((count >= 2) && (bom[0] == 0xFF) && (bom[1] == 0xFE))
+        return fclose(stream), calcCreateSourceStreamFromFile(path, cleanupPath, CALC_SOURCE_ENCODING_UTF_16LE);
+
+    if ((count == 3) && (bom[0] == 0xEF) && (bom[1] == 0xBB) && (bom[2] == 0xBF))
+        encoding = CALC_SOURCE_ENCODING_UTF_8, count = 0;
+
+    sourceStream = calc_CreateSourceStream(path, stream, FALSE, FALSE, TRUE, cleanupPath, encoding, calc_CreateSourceStreamRing(CALC_SOURCE_STREAM_REFILL_SIZE << 1), NULL);
+
+    // The bytes that are not a BOM begin the ring, and its mirror.
+    bufcpy(sourceStream->buffer->data, bom, count);
+    bufcpy(sourceStream->buffer->data + (size_t)sourceStream->bufferMask + 1, bom, count);
+
+    sourceStream->bufferEnd = count;
+
+    return sourceStream;
 }
 
 CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenStandardSourceStream(void)
 {
-    return calc_CreateSourceStream("<stdin>", stdin, TRUE, FALSE, TRUE, FALSE, CALC_DEFAULT_ENCODING, calcCreateSourceBuffer(CALC_PAGESIZ, NULL, 0));
+    return calc_CreateSourceStream("<stdin>", stdin, TRUE, FALSE, TRUE, FALSE, CALC_DEFAULT_ENCODING, calc_CreateSourceStreamRing(CALC_SOURCE_STREAM_REFILL_SIZE << 1), NULL);
+}
+
+CALC_API CalcSourceStream_t *CALC_STDCALL calcOpenSourceStreamFromReader(const char *const name, CalcSourceReader_t reader, void *const context, CalcSourceEncoding_t encoding)
+{
+    assert(reader != NULL);
+
+    CalcSourceStream_t *sourceStream = calc_CreateSourceStream(name, NULL, FALSE, FALSE, TRUE, FALSE, encoding, calc_CreateSourceStreamRing(CALC_SOURCE_STREAM_REFILL_SIZE << 1), NULL);
+
+    sourceStream->reader = reader;
+    sourceStream->readerContext = context;
+
+    return sourceStream;
 }
 
-static inline bool_t CALC_STDCALL calc_SourceStreamNeedsARefill(CalcSourceStream_t *const sourceStream, uint32_t offset)
+CALC_API size_t CALC_STDCALL calcSetSourceStreamRefillSize(CalcSourceStream_t *const sourceStream, size_t refillSize)
 {
-    return !sourceStream->isInitialized || ((sourceStream->forwardLocation.ch + offset) >= sourceStream->buffer->size);
+    size_t size = 16;
+
+    while (size < refillSize)
+        size <<= 1;
+
+    return sourceStream->refillSize = size;
 }
 
-static inline bool_t CALC_STDCALL calc_SourceStreamRefill(CalcSourceStream_t *const sourceStream)
+CALC_API bool_t CALC_STDCALL calcSetSourceStreamMemoryBudget(CalcSourceStream_t *const sourceStream, size_t memoryBudget)
 {
-    if (!sourceStream->isOpen || !sourceStream->stream)
+    if (!sourceStream->isOpen || (memoryBudget && (sourceStream->buffer->size > memoryBudget)))
         return FALSE;
 
-    FILE *stream = sourceStream->stream;
-    byte_t *data = sourceStream->buffer->data;
-    size_t begin = sourceStream->beginLocation.ch, count = sourceStream->buffer->size - begin;
+    sourceStream->memoryBudget = memoryBudget;
+
+    return TRUE;
+}
+
+CALC_API bool_t CALC_STDCALL calcSetSourceStreamLazyLocations(CalcSourceStream_t *const sourceStream, bool_t isLazy)
+{
+    if (sourceStream->forwardLocation.ch || sourceStream->streamLocation.ch)
+        return FALSE;
+
+    sourceStream->isLazy = isLazy;
+    calcResetSourceLocation(&sourceStream->anchorLocation);
+
+    calc_SourceStreamSelect(sourceStream);
+
+    return TRUE;
+}
+
+CALC_API bool_t CALC_STDCALL calcSourceStreamResolveLocation(CalcSourceStream_t *const sourceStream, CalcSourceLocation_t *const sourceLocation)
+{
+    CalcSourceLocation_t location;
+    CalcSourceLine_t line;
+
+    if (!sourceStream->isOpen)
+    {
+        if (!calcSourceBufferFindLine(sourceStream->buffer, (size_t)sourceLocation->ch, &line))
+            return FALSE;
+
+        sourceLocation->ln = line.ln;
+        sourceLocation->co = calc_SourceStreamColumns(sourceStream, line.text, (size_t)line.co);
+
+        return TRUE;
+    }
 
-    if (feof(stream))
+    // Eager streams know the location of the lexeme, which is retained.
+    location = sourceStream->isLazy ? sourceStream->anchorLocation : sourceStream->beginLocation;
+
+    if ((sourceLocation->ch < location.ch) || (sourceLocation->ch > sourceStream->bufferEnd))
         return FALSE;
 
-    if (begin)
-        bufmov(data, (data + begin), count);
+    calc_SourceStreamCount(sourceStream, &location, sourceStream->buffer->data + (size_t)(location.ch & sourceStream->bufferMask), (size_t)(sourceLocation->ch - location.ch));
+
+    sourceLocation->ln = location.ln;
+    sourceLocation->co = location.co;
+
+    return TRUE;
+}
 
-    if (!sourceStream->isStdin)
-        fread((void *)(data + begin), sizeof(byte_t), count, stream);
+CALC_API bool_t CALC_STDCALL calcSourceStreamEnablePrefetch(CalcSourceStream_t *const sourceStream, size_t segmentCount)
+{
+    if (!sourceStream->isOpen || !sourceStream->stream || sourceStream->isInteractive)
+        return FALSE;
+
+    if (!sourceStream->prefetcher)
+        sourceStream->prefetcher = calcCreateSourcePrefetcher(sourceStream->stream, sourceStream->refillSize, segmentCount);
+
+    return (bool_t)(sourceStream->prefetcher != NULL);
+}
+
+CALC_API void CALC_STDCALL calcSourceStreamBeginLexeme(CalcSourceStream_t *const sourceStream)
+{
+    sourceStream->beginLocation = sourceStream->forwardLocation;
+    sourceStream->isOverflowed = FALSE;
+    sourceStream->isLexing = TRUE;
+
+    return;
+}
+
+CALC_API void CALC_STDCALL calcSourceStreamCheckpoint(CalcSourceStream_t *const sourceStream, CalcSourceCheckpoint_t *const outCheckpoint)
+{
+    outCheckpoint->streamLocation = sourceStream->streamLocation;
+    outCheckpoint->beginLocation = sourceStream->beginLocation;
+    outCheckpoint->forwardLocation = sourceStream->forwardLocation;
+
+    // While checkpoints are alive the oldest pinned byte only moves back,
+    // so they can be released in any order.
+    if (!sourceStream->checkpointCount++ || (sourceStream->beginLocation.ch < sourceStream->checkpointPosition))
+        sourceStream->checkpointPosition = sourceStream->beginLocation.ch;
+
+    return;
+}
+
+CALC_API void CALC_STDCALL calcSourceStreamRewind(CalcSourceStream_t *const sourceStream, const CalcSourceCheckpoint_t *const checkpoint)
+{
+    sourceStream->streamLocation = checkpoint->streamLocation;
+    sourceStream->beginLocation = checkpoint->beginLocation;
+    sourceStream->forwardLocation = checkpoint->forwardLocation;
+    sourceStream->isOverflowed = FALSE;
+
+    // The characters decoded ahead and the ASCII run belong to the abandoned
+    // cursor.
+    sourceStream->lookaheadCount = 0;
+    sourceStream->asciiBegin = 0;
+    sourceStream->asciiEnd = 0;
+
+    return;
+}
+
+CALC_API void CALC_STDCALL calcSourceStreamReleaseCheckpoint(CalcSourceStream_t *const sourceStream, const CalcSourceCheckpoint_t *const checkpoint)
+{
+    assert(sourceStream->checkpointCount > 0);
+
+    (void)checkpoint;
+
+    if (sourceStream->checkpointCount)
+        sourceStream->checkpointCount--;
+
+    return;
+}
+
+/// @brief Copies count bytes stored at the specified index of the ring into
+///        their mirrored locations.
+static inline void CALC_STDCALL calc_SourceStreamMirror(CalcSourceStream_t *const sourceStream, size_t index, size_t count)
+{
+    byte_t *data = sourceStream->buffer->data;
+    size_t capacity = (size_t)sourceStream->bufferMask + 1;
+
+    if ((index + count) <= capacity)
+    {
+        bufcpy(data + index + capacity, data + index, count);
+    }
     else
-        fgets((char *)(data + begin), count, stream);
+    {
+        bufcpy(data + index + capacity, data + index, capacity - index);
+        bufcpy(data, data + capacity, (index + count) - capacity);
+    }
+
+    return;
+}
+
+/// @brief Grows the ring of an open source stream to the specified capacity,
+///        moving only the retained bytes.
+static inline void CALC_STDCALL calc_SourceStreamGrow(CalcSourceStream_t *const sourceStream, uint64_t retained, size_t capacity)
+{
+    CalcSourceBuffer_t *oldBuffer = sourceStream->buffer, *newBuffer = calc_CreateSourceStreamRing(capacity);
+    size_t count = (size_t)(sourceStream->bufferEnd - retained), index = (size_t)(retained & (capacity - 1));
+
+    bufcpy(newBuffer->data + index, oldBuffer->data + (size_t)(retained & sourceStream->bufferMask), count);
+
+    sourceStream->buffer = newBuffer;
+    sourceStream->bufferMask = capacity - 1;
+
+    calc_SourceStreamMirror(sourceStream, index, count);
+    calcDeleteSourceBuffer(oldBuffer);
 
-    if (!sourceStream->isInitialized)
+    return;
+}
+
+/// @brief Reads the next line of an interactive file stream, or at most count
+///        bytes of it.
+static size_t CALC_STDCALL calc_SourceStreamReadLine(FILE *const stream, byte_t *const buffer, size_t count)
+{
+    size_t length = 0;
+    int c;
+
+    while ((length < count) && ((c = getc(stream)) != EOF))
     {
-        sourceStream->isInitialized = TRUE;
+        buffer[length++] = (byte_t)c;
+
+        if (c == EOL)
+            break;
     }
+
+    return length;
+}
+
+/// @brief Reads the next block of bytes of the file stream.
+static inline size_t CALC_STDCALL calc_SourceStreamReadBlock(CalcSourceStream_t *const sourceStream, byte_t *const buffer, size_t count)
+{
+    if (sourceStream->prefetcher)
+        return calcSourcePrefetcherRead(sourceStream->prefetcher, buffer, count);
+    else if (sourceStream->reader)
+        return sourceStream->reader(sourceStream->readerContext, buffer, count);
+    else if (!sourceStream->isInteractive)
+        return fread((void *)buffer, sizeof(byte_t), count, sourceStream->stream);
     else
+        return calc_SourceStreamReadLine(sourceStream->stream, buffer, count);
+}
+
+static inline bool_t CALC_STDCALL calc_SourceStreamRefill(CalcSourceStream_t *const sourceStream)
+{
+    if (!sourceStream->isOpen || (!sourceStream->stream && !sourceStream->reader))
+        return FALSE;
+
+    // Without lexemes the stream is read like a plain file, the bytes that
+    // precede the cursor are never read again.
+    if (!sourceStream->isLexing)
+        sourceStream->beginLocation = sourceStream->forwardLocation;
+
+    uint64_t retained = !sourceStream->checkpointCount ? sourceStream->beginLocation.ch : min(sourceStream->beginLocation.ch, sourceStream->checkpointPosition);
+    size_t used = (size_t)(sourceStream->bufferEnd - retained), capacity = (size_t)sourceStream->bufferMask + 1, limit, index, count;
+
+    // The bytes before the lexeme may be overwritten, so lazy locations are
+    // counted up to it while they're still in the ring.
+    if (sourceStream->isLazy && (retained > sourceStream->anchorLocation.ch))
+    {
+        calc_SourceStreamCount(sourceStream, &sourceStream->anchorLocation, sourceStream->buffer->data + (size_t)(sourceStream->anchorLocation.ch & sourceStream->bufferMask), (size_t)(retained - sourceStream->anchorLocation.ch));
+        sourceStream->anchorLocation.ch = retained;
+    }
+
+    // The prefetcher may have reached the end of the file stream while its
+    // segments are still to be consumed.
+    if (!sourceStream->prefetcher && sourceStream->stream && feof(sourceStream->stream))
+        return FALSE;
+
+    // Lexemes are never moved, unless they outgrow the ring. The ring is
+    // mirrored, so its capacity is at most half of the memory budget.
+    if ((capacity - used) < sourceStream->refillSize)
     {
-        CalcSourceLocation_t *beginLoc = &sourceStream->beginLocation, *forwardLoc = &sourceStream->forwardLocation;
+        limit = sourceStream->memoryBudget ? (sourceStream->memoryBudget >> 1) : ~(size_t)0;
+        count = capacity;
+
+        while (((capacity - used) < sourceStream->refillSize) && (capacity <= (limit >> 1)))
+            capacity <<= 1;
+
+        if (capacity != count)
+            calc_SourceStreamGrow(sourceStream, retained, capacity);
+    }
+
+    // Within the budget the bytes before the lexeme are overwritten, so the
+    // next block may be smaller than the refill size.
+    if (!(count = min(sourceStream->refillSize, capacity - used)))
+        return sourceStream->isOverflowed = TRUE, FALSE;
+
+    index = (size_t)(sourceStream->bufferEnd & sourceStream->bufferMask);
 
-        if (begin)
-            calcSetSourceLocation(forwardLoc, forwardLoc->ch - beginLoc->ch, forwardLoc->co - beginLoc->co, forwardLoc->ln - beginLoc->ln);
-        else
-            calcResetSourceLocation(forwardLoc);
+    count = calc_SourceStreamReadBlock(sourceStream, sourceStream->buffer->data + index, count);
 
-        calcResetSourceLocation(beginLoc);
+    calc_SourceStreamMirror(sourceStream, index, count);
+
+    sourceStream->bufferEnd += count;
+    sourceStream->isInitialized = TRUE;
+
+    return (bool_t)(count > 0);
+}
+
+/// @brief Ensures that at least count bytes starting from the specified
+///        position are stored in the buffer, refilling it when it's needed.
+/// @return TRUE if at least one byte is available at the position.
+static inline bool_t CALC_STDCALL calc_SourceStreamEnsure(CalcSourceStream_t *const sourceStream, uint64_t position, size_t count)
+{
+    while ((position + count) > sourceStream->bufferEnd)
+    {
+        if (!calc_SourceStreamRefill(sourceStream))
+            return (bool_t)(position < sourceStream->bufferEnd);
     }
 
     return TRUE;
 }
 
-CALC_API int32_t CALC_STDCALL calcSourceStreamPeek(CalcSourceStream_t *const sourceStream)
+/// @brief Finds the run of ASCII bytes starting from the specified position,
+///        scanning all the bytes alredy stored in the buffer.
+/// @return TRUE if the byte at the position is an ASCII byte.
+static inline bool_t CALC_STDCALL calc_SourceStreamScanAscii(CalcSourceStream_t *const sourceStream, uint64_t position)
 {
-    if (calc_SourceStreamNeedsARefill(sourceStream, 0) && !calc_SourceStreamRefill(sourceStream))
-        return EOF;
-    else
-        return calcSourceBufferGetChar(sourceStream->buffer, sourceStream->encoding, sourceStream->forwardLocation.ch, NULL);
+    const byte_t *data = sourceStream->buffer->data + (size_t)(position & sourceStream->bufferMask);
+
+    // Open source streams never store more than capacity bytes after the
+    // position, so they're all contiguous in the ring.
+    sourceStream->asciiBegin = position;
+    sourceStream->asciiEnd = position + bufascii(data, (size_t)(sourceStream->bufferEnd - position));
+
+    return (bool_t)(sourceStream->asciiEnd > position);
 }
 
-static inline int32_t CALC_STDCALL calc_SourceStreamRead(CalcSourceStream_t *const sourceStream, ssize_t *const outOffset)
+/// @brief Decodes the character at the specified position, out of the runs of
+///        ASCII bytes. The encoding is a constant in each instance generated
+///        by calcDefineSourceDecoder, so the switch is resolved at compile
+///        time.
+static inline int32_t CALC_STDCALL calc_SourceStreamDecode(CalcSourceStream_t *const sourceStream, uint64_t position, ssize_t *const outOffset, CalcSourceEncoding_t encoding)
 {
-    if (calc_SourceStreamNeedsARefill(sourceStream, 0) && !calc_SourceStreamRefill(sourceStream))
-        return EOF;
+    const byte_t *data;
+    int32_t result;
+
+    if (!calc_SourceStreamEnsure(sourceStream, position, 1))
+        return *outOffset = 0, EOF;
+
+    data = sourceStream->buffer->data + (size_t)(position & sourceStream->bufferMask);
+
+    switch (encoding)
+    {
+    case CALC_SOURCE_ENCODING_ASCII:
+        calc_SourceStreamScanAscii(sourceStream, position);
+        result = *data;
+        *outOffset = 1;
+        break;
+
+    case CALC_SOURCE_ENCODING_UTF_8:
+        if (calc_SourceStreamScanAscii(sourceStream, position))
+        {
+            result = *data;
+            *outOffset = 1;
+            break;
+        }
+
+        if (sourceStream->buffer->isValidated && ((*outOffset = utf8_decode((const uint8_t *)data, &result)) > 0))
+            break;
+
+        // A multi-byte sequence may be split by a refill boundary.
+        if ((*data >= 0xC0) && calc_SourceStreamEnsure(sourceStream, position, (*data < 0xE0) ? 2 : (*data < 0xF0) ? 3 : 4))
+            data = sourceStream->buffer->data + (size_t)(position & sourceStream->bufferMask);
+
+        *outOffset = utf8_iterate((const uint8_t *)data, (ssize_t)min(sourceStream->bufferEnd - position, 4), &result);
+
+        if (*outOffset < 0)
+            result = CALC_SOURCE_INVALID_CHAR, *outOffset = 1;
+
+        break;
+
+    default:
+        return unreach(), EOF;
+    }
+
+    return result;
+}
+
+static inline int32_t CALC_STDCALL calc_SourceStreamGetChar(CalcSourceStream_t *const sourceStream, uint64_t position, ssize_t *const outOffset, CalcSourceDecodeChar_t decodeChar)
+{
+    ssize_t offset;
+
+    // Inside a run of ASCII bytes characters are bytes, and they're alredy
+    // stored in the buffer.
+    if ((position - sourceStream->asciiBegin) < (sourceStream->asciiEnd - sourceStream->asciiBegin))
+    {
+        if (outOffset)
+            *outOffset = 1;
+
+        return sourceStream->buffer->data[(size_t)(position & sourceStream->bufferMask)];
+    }
+
+    return decodeChar(sourceStream, position, !outOffset ? &offset : outOffset);
+}
+
+/// @brief Gets the character at the specified offset of the lookahead window,
+///        decoding the missing characters before it.
+static inline CalcSourceChar_t *CALC_STDCALL calc_SourceStreamLookahead(CalcSourceStream_t *const sourceStream, uint32_t offset)
+{
+    CalcSourceChar_t *sourceChar;
+    ssize_t width;
+
+    if (!sourceStream->lookaheadCount)
+        sourceStream->lookaheadEnd = sourceStream->forwardLocation.ch;
+
+    while (sourceStream->lookaheadCount <= offset)
+    {
+        // Nothing follows the end of the stream.
+        if (sourceStream->lookaheadCount && (sourceStream->lookahead[(sourceStream->lookaheadHead + sourceStream->lookaheadCount - 1) & (CALC_SOURCE_STREAM_LOOKAHEAD - 1)].value == EOF))
+            return &sourceStream->lookahead[(sourceStream->lookaheadHead + sourceStream->lookaheadCount - 1) & (CALC_SOURCE_STREAM_LOOKAHEAD - 1)];
+
+        sourceChar = &sourceStream->lookahead[(sourceStream->lookaheadHead + sourceStream->lookaheadCount) & (CALC_SOURCE_STREAM_LOOKAHEAD - 1)];
+        sourceChar->value = calc_SourceStreamGetChar(sourceStream, sourceStream->lookaheadEnd, &width, sourceStream->decoder->decodeChar);
+        sourceChar->width = (uint32_t)width;
+
+        sourceStream->lookaheadEnd += width;
+        sourceStream->lookaheadCount++;
+    }
+
+    return &sourceStream->lookahead[(sourceStream->lookaheadHead + offset) & (CALC_SOURCE_STREAM_LOOKAHEAD - 1)];
+}
 
+static inline int32_t CALC_STDCALL calc_SourceStreamPeek(CalcSourceStream_t *const sourceStream, CalcSourceDecodeChar_t decodeChar)
+{
+    if (sourceStream->lookaheadCount)
+        return sourceStream->lookahead[sourceStream->lookaheadHead].value;
+    else
+        return calc_SourceStreamGetChar(sourceStream, sourceStream->forwardLocation.ch, NULL, decodeChar);
+}
+
+/// @brief Reads the next character. The tracking mode is a constant in each
+///        instance generated by calcDefineSourceDecoder: lazy reads only move
+///        the byte offsets.
+static inline int32_t CALC_STDCALL calc_SourceStreamRead(CalcSourceStream_t *const sourceStream, ssize_t *const outOffset, CalcSourceDecodeChar_t decodeChar, bool_t isLazy)
+{
     int32_t result;
     ssize_t offset;
 
-    result = calcSourceBufferGetChar(sourceStream->buffer, sourceStream->encoding, sourceStream->forwardLocation.ch, &offset);
+    if (!sourceStream->lookaheadCount)
+    {
+        result = calc_SourceStreamGetChar(sourceStream, sourceStream->forwardLocation.ch, &offset, decodeChar);
+    }
+    else
+    {
+        result = sourceStream->lookahead[sourceStream->lookaheadHead].value;
+        offset = (ssize_t)sourceStream->lookahead[sourceStream->lookaheadHead].width;
+
+        sourceStream->lookaheadHead = (sourceStream->lookaheadHead + 1) & (CALC_SOURCE_STREAM_LOOKAHEAD - 1);
+        sourceStream->lookaheadCount--;
+    }
 
-    switch (result)
+    // Columns are characters, whatever the number of their bytes.
+    switch (isLazy ? NUL : result)
     {
     case EOF:
     case NUL:
@@ -171,35 +717,323 @@ static inline int32_t CALC_STDCALL calc_SourceStreamRead(CalcSourceStream_t *con
         break;
 
     default:
-        sourceStream->streamLocation.co += offset;
-        sourceStream->forwardLocation.co += offset;
+        sourceStream->streamLocation.co++;
+        sourceStream->forwardLocation.co++;
         break;
     }
 
     sourceStream->streamLocation.ch += offset;
     sourceStream->forwardLocation.ch += offset;
 
-    if (outOffset && *outOffset)
+    if (outOffset)
         *outOffset = offset;
 
     return result;
 }
 
+#pragma push_macro("calcDefineSourceDecoder")
+
+#ifndef calcDefineSourceDecoder
+/// @brief Defines the functions of a source stream specialized for an encoding,
+///        the decoding slow path is called directly by the fast paths.
+#   define calcDefineSourceDecoder(name)                                                                                                                    \
+        static int32_t CALC_STDCALL calc_SourceStreamDecodeChar_##name(CalcSourceStream_t *const sourceStream, uint64_t position, ssize_t *const outOffset) \
+        {                                                                                                                                                   \
+            return calc_SourceStreamDecode(sourceStream, position, outOffset, CALC_SOURCE_ENCODING_##name);                                                 \
+        }                                                                                                                                                   \
+                                                                                                                                                            \
+        static int32_t CALC_STDCALL calc_SourceStreamPeek_##name(CalcSourceStream_t *const sourceStream)                                                    \
+        {                                                                                                                                                   \
+            return calc_SourceStreamPeek(sourceStream, calc_SourceStreamDecodeChar_##name);                                                                 \
+        }                                                                                                                                                   \
+                                                                                                                                                            \
+        static int32_t CALC_STDCALL calc_SourceStreamRead_##name(CalcSourceStream_t *const sourceStream)                                                    \
+        {                                                                                                                                                   \
+            return calc_SourceStreamRead(sourceStream, NULL, calc_SourceStreamDecodeChar_##name, FALSE);                                                    \
+        }                                                                                                                                                   \
+                                                                                                                                                            \
+        static int32_t CALC_STDCALL calc_SourceStreamReadLazy_##name(CalcSourceStream_t *const sourceStream)                                                \
+        {                                                                                                                                                   \
+            return calc_SourceStreamRead(sourceStream, NULL, calc_SourceStreamDecodeChar_##name, TRUE);                                                     \
+        }
+#endif // calcDefineSourceDecoder
+
+#include "source_decoders.inc"
+
+#ifdef calcDefineSourceDecoder
+#   undef calcDefineSourceDecoder
+#endif // UNDEF calcDefineSourceDecoder
+
+/// @brief Decoders of the encodings that source streams can read.
+static const CalcSourceDecoder_t calc_SourceDecoders[] = {
+#ifndef calcDefineSourceDecoder
+/// @brief Defines the entry of the table of an encoding.
+#   define calcDefineSourceDecoder(name) { CALC_SOURCE_ENCODING_##name, calc_SourceStreamDecodeChar_##name, calc_SourceStreamPeek_##name, calc_SourceStreamRead_##name, calc_SourceStreamReadLazy_##name },
+#endif // calcDefineSourceDecoder
+
+#include "source_decoders.inc"
+
+#ifdef calcDefineSourceDecoder
+#   undef calcDefineSourceDecoder
+#endif // UNDEF calcDefineSourceDecoder
+};
+
+#pragma pop_macro("calcDefineSourceDecoder")
+
+/// @brief Advances the lines, the columns and the byte offsets of the
+///        locations over a sequence of consumed bytes.
+static void CALC_STDCALL calc_SourceStreamAdvance(CalcSourceStream_t *const sourceStream, const byte_t *const data, size_t length)
+{
+    calc_SourceStreamCount(sourceStream, &sourceStream->forwardLocation, data, length);
+
+    sourceStream->streamLocation.ln = sourceStream->forwardLocation.ln;
+    sourceStream->streamLocation.co = sourceStream->forwardLocation.co;
+    sourceStream->streamLocation.ch += length;
+    sourceStream->forwardLocation.ch += length;
+
+    return;
+}
+
+/// @brief Advances only the byte offsets of the locations over a sequence of
+///        consumed bytes (see calcSetSourceStreamLazyLocations).
+static void CALC_STDCALL calc_SourceStreamAdvanceLazy(CalcSourceStream_t *const sourceStream, const byte_t *const data, size_t length)
+{
+    (void)data;
+
+    sourceStream->streamLocation.ch += length;
+    sourceStream->forwardLocation.ch += length;
+
+    return;
+}
+
+/// @brief Chooses the functions of a source stream for its decoder and its
+///        location tracking mode, so reads never dispatch on them.
+static void CALC_STDCALL calc_SourceStreamSelect(CalcSourceStream_t *const sourceStream)
+{
+    if (!sourceStream->isLazy)
+    {
+        sourceStream->read = sourceStream->decoder->read;
+        sourceStream->advance = calc_SourceStreamAdvance;
+    }
+    else
+    {
+        sourceStream->read = sourceStream->decoder->readLazy;
+        sourceStream->advance = calc_SourceStreamAdvanceLazy;
+    }
+
+    return;
+}
+
+/// @brief Gets the decoder of an encoding, sources in the other encodings
+///        are read as UTF-8 since they're transcoded on load.
+static const CalcSourceDecoder_t *CALC_STDCALL calc_GetSourceDecoder(CalcSourceEncoding_t encoding)
+{
+    size_t i;
+
+    for (i = 0; i < countof(calc_SourceDecoders); i++)
+    {
+        if (calc_SourceDecoders[i].encoding == encoding)
+            return &calc_SourceDecoders[i];
+    }
+
+    return calc_GetSourceDecoder(CALC_SOURCE_ENCODING_UTF_8);
+}
+
+CALC_API int32_t CALC_STDCALL calcSourceStreamPeek(CalcSourceStream_t *const sourceStream)
+{
+    return sourceStream->decoder->peek(sourceStream);
+}
+
 CALC_API int32_t CALC_STDCALL calcSourceStreamRead(CalcSourceStream_t *const sourceStream)
 {
-    return calc_SourceStreamRead(sourceStream, NULL);
+    return sourceStream->read(sourceStream);
 }
 
-CALC_API int32_t CALC_STDCALL calcSourceStreamPeekOffset(CalcSourceStream_t *const sourceStream, uint32_t offset)
+/// @brief Classes of each byte, as combinations of CalcSourceClass_t values.
+static const byte_t calc_SourceClasses[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+};
+
+/// @brief Gets the position next to the last byte of content stored in the
+///        buffer: the NUL sentinel of whole buffers is not content.
+static inline uint64_t CALC_STDCALL calc_SourceStreamContentEnd(CalcSourceStream_t *const sourceStream)
 {
-    return calcSourceBufferGetChar(sourceStream->buffer, sourceStream->encoding, sourceStream->forwardLocation.ch + offset, NULL);
+    if (sourceStream->isOpen || !sourceStream->bufferEnd)
+        return sourceStream->bufferEnd;
+    else
+        return sourceStream->bufferEnd - 1;
 }
 
-CALC_API int32_t CALC_STDCALL calcSourceStreamReadOffset(CalcSourceStream_t *const sourceStream, uint32_t offset)
+/// @brief Consumes the bytes from the current position to the specified one,
+///        updating the locations of the stream and the span.
+static inline size_t CALC_STDCALL calc_SourceStreamConsume(CalcSourceStream_t *const sourceStream, uint64_t position, CalcSourceSpan_t *const outSpan)
 {
-    if (calc_SourceStreamNeedsARefill(sourceStream, offset) && !calc_SourceStreamRefill(sourceStream))
+    uint64_t start = sourceStream->forwardLocation.ch;
+    size_t length = (size_t)(position - start);
+
+    const byte_t *data = sourceStream->buffer->data + (size_t)(start & sourceStream->bufferMask);
+
+    sourceStream->advance(sourceStream, data, length);
+
+    if (outSpan)
+    {
+        outSpan->data = data;
+        outSpan->length = length;
+    }
+
+    if (length)
+        sourceStream->lookaheadCount = 0;
+
+    return length;
+}
+
+CALC_API size_t CALC_STDCALL calcSourceStreamReadWhile(CalcSourceStream_t *const sourceStream, int classes, CalcSourceSpan_t *const outSpan)
+{
+    uint64_t position = sourceStream->forwardLocation.ch, end;
+    const byte_t *data;
+    size_t count, i;
+
+    while (calc_SourceStreamEnsure(sourceStream, position, 1))
+    {
+        // The ring may be moved by a refill, so the bytes are addressed
+        // again on each pass.
+        data = sourceStream->buffer->data + (size_t)(position & sourceStream->bufferMask);
+        end = calc_SourceStreamContentEnd(sourceStream);
+        count = (end > position) ? (size_t)(end - position) : 0;
+
+        for (i = 0; (i < count) && (calc_SourceClasses[data[i]] & classes); i++)
+            ;
+
+        position += i;
+
+        if ((i < count) || !count)
+            break;
+    }
+
+    return calc_SourceStreamConsume(sourceStream, position, outSpan);
+}
+
+CALC_API size_t CALC_STDCALL calcSourceStreamReadUntil(CalcSourceStream_t *const sourceStream, byte_t delimiter, CalcSourceSpan_t *const outSpan)
+{
+    uint64_t position = sourceStream->forwardLocation.ch, end;
+    const byte_t *data, *found;
+    size_t count;
+
+    while (calc_SourceStreamEnsure(sourceStream, position, 1))
+    {
+        data = sourceStream->buffer->data + (size_t)(position & sourceStream->bufferMask);
+        end = calc_SourceStreamContentEnd(sourceStream);
+        count = (end > position) ? (size_t)(end - position) : 0;
+
+        if ((found = (const byte_t *)memchr(data, delimiter, count)) != NULL)
+        {
+            position += (uint64_t)(found - data);
+            break;
+        }
+
+        position += count;
+
+        if (!count)
+            break;
+    }
+
+    return calc_SourceStreamConsume(sourceStream, position, outSpan);
+}
+
+CALC_API size_t CALC_STDCALL calcSourceStreamPeekBytes(CalcSourceStream_t *const sourceStream, size_t count, CalcSourceSpan_t *const outSpan)
+{
+    uint64_t position = sourceStream->forwardLocation.ch, end;
+
+    calc_SourceStreamEnsure(sourceStream, position, count);
+
+    // The ring may be moved by the refills, so the bytes are addressed after
+    // them.
+    end = calc_SourceStreamContentEnd(sourceStream);
+
+    outSpan->data = sourceStream->buffer->data + (size_t)(position & sourceStream->bufferMask);
+    outSpan->length = (end > position) ? (size_t)(end - position) : 0;
+
+    return outSpan->length;
+}
+
+CALC_API size_t CALC_STDCALL calcSourceStreamReadBytes(CalcSourceStream_t *const sourceStream, size_t count, CalcSourceSpan_t *const outSpan)
+{
+    uint64_t position = sourceStream->forwardLocation.ch, end;
+
+    calc_SourceStreamEnsure(sourceStream, position, count);
+
+    end = calc_SourceStreamContentEnd(sourceStream);
+
+    if ((position + count) > end)
+        count = (end > position) ? (size_t)(end - position) : 0;
+
+    return calc_SourceStreamConsume(sourceStream, position + count, outSpan);
+}
+
+CALC_API size_t CALC_STDCALL calcSourceStreamReadLexeme(CalcSourceStream_t *const sourceStream, size_t skip, size_t count, CalcSourceSpan_t *const outSpan)
+{
+    uint64_t position = sourceStream->forwardLocation.ch, end;
+
+    calc_SourceStreamEnsure(sourceStream, position, skip + count);
+
+    end = calc_SourceStreamContentEnd(sourceStream);
+
+    if ((position + skip + count) > end)
+    {
+        skip = (size_t)min(skip, (end > position) ? (end - position) : 0);
+        count = (size_t)((end > (position + skip)) ? (end - position - skip) : 0);
+    }
+
+    if (skip)
+        calc_SourceStreamConsume(sourceStream, position + skip, NULL);
+
+    sourceStream->beginLocation = sourceStream->forwardLocation;
+    sourceStream->isOverflowed = FALSE;
+    sourceStream->isLexing = TRUE;
+
+    return calc_SourceStreamConsume(sourceStream, position + skip + count, outSpan);
+}
+
+CALC_API int32_t CALC_STDCALL calcSourceStreamPeekOffset(CalcSourceStream_t *const sourceStream, uint32_t offset)
+{
+    uint64_t position;
+    ssize_t width;
+    int32_t result;
+
+    if (offset < CALC_SOURCE_STREAM_LOOKAHEAD)
+        return calc_SourceStreamLookahead(sourceStream, offset)->value;
+
+    // Farther characters are decoded on each call, starting from the end of
+    // the lookahead window.
+    if (calc_SourceStreamLookahead(sourceStream, CALC_SOURCE_STREAM_LOOKAHEAD - 1)->value == EOF)
         return EOF;
 
+    position = sourceStream->lookaheadEnd;
+    offset -= CALC_SOURCE_STREAM_LOOKAHEAD;
+
+    while (((result = calc_SourceStreamGetChar(sourceStream, position, &width, sourceStream->decoder->decodeChar)) != EOF) && offset--)
+        position += width;
+
+    return result;
+}
+
+CALC_API int32_t CALC_STDCALL calcSourceStreamReadOffset(CalcSourceStream_t *const sourceStream, uint32_t offset)
+{
     int32_t result = EOF;
     uint32_t i;
 
@@ -211,7 +1045,15 @@ CALC_API int32_t CALC_STDCALL calcSourceStreamReadOffset(CalcSourceStream_t *con
 
 CALC_API bool_t CALC_STDCALL calcCloseSourceStream(CalcSourceStream_t *const sourceStream)
 {
-    if (sourceStream->isOpen)
+    if (sourceStream->prefetcher)
+    {
+        calcDeleteSourcePrefetcher(sourceStream->prefetcher);
+        sourceStream->prefetcher = NULL;
+    }
+
+    if (sourceStream->isOpen && !sourceStream->stream)
+        return sourceStream->isOpen = FALSE, TRUE;
+    else if (sourceStream->isOpen)
         return sourceStream->isOpen = (bool_t)fclose(sourceStream->stream);
     else
         return FALSE;
@@ -219,18 +1061,31 @@ CALC_API bool_t CALC_STDCALL calcCloseSourceStream(CalcSourceStream_t *const sou
 
 CALC_API bool_t CALC_STDCALL calcClearSourceStream(CalcSourceStream_t *const sourceStream)
 {
+    if (sourceStream->isShared)
+        return FALSE;
+
     return calcClearSourceBuffer(sourceStream->buffer);
 }
 
 CALC_API void CALC_STDCALL calcDeleteSourceStream(CalcSourceStream_t *const sourceStream)
 {
     calcCloseSourceStream(sourceStream);
-    calcDeleteSourceBuffer(sourceStream->buffer);
 
     if (sourceStream->cleanup)
         free(sourceStream->path);
 
-    free(sourceStream);
+    if (sourceStream->pool)
+    {
+        calcSourcePoolReleaseBuffer(sourceStream->pool, sourceStream->buffer);
+        calcSourcePoolReleaseStream(sourceStream->pool, sourceStream);
+    }
+    else
+    {
+        if (!sourceStream->isShared)
+            calcDeleteSourceBuffer(sourceStream->buffer);
+
+        free(sourceStream);
+    }
 
     return;
 }
@@ -0,0 +1,235 @@
+#include "calc/base/string.h"
+#include "calc/lex/lexer.h"
+#include "calc/source/source_manager.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define COUNT 4096
+
+typedef struct _Text
+{
+    const char *data;
+    size_t      position;
+} Text_t;
+
+typedef struct _Expected
+{
+    CalcTokenCode_t code;
+    const char     *lexeme;
+} Expected_t;
+
+static const char *const source =
+    "#include \"io.calc\"\n"
+    "#iffy #if #!\n"
+    "fn main() -> int {\n"
+    "    let x := 0x1F + 0b101 + 0c17 + 0d42 + 42 + 3.14 + .5 + 0x.8;\n"
+    "    x >>= 1; x ?? y?.z; a...b; 0..9; 12.x;\n"
+    "    // a comment longer than the thirty-two bytes of a block\n"
+    "    long_identifier_longer_than_the_32_bytes_of_a_block_\xC3\xA8                                        ;\n"
+    "    c = 'a' + '\\n' + '\\101' + '\\x41' + '\\u20AC' + '\xC3\xA0';\n"
+    "    /* block ** comment */ this.get = \"str \\\" \xE2\x82\xAC\";\n"
+    "    \xCE\xBB_1 $ \"unterminated\n"
+    "}";
+
+static const Expected_t expected[] = {
+    { CALC_TOKEN_DIRECTIVE_INCLUDE,         "#include" },
+    { CALC_TOKEN_LITERAL_STRING,            "\"io.calc\"" },
+    { CALC_TOKEN_INVALID,                   "#iffy" },
+    { CALC_TOKEN_DIRECTIVE_IF,              "#if" },
+    { CALC_TOKEN_PUNCTOR_SHARP_EXCLM,       "#!" },
+    { CALC_TOKEN_KEYWORD_FUNCTION,          "fn" },
+    { CALC_TOKEN_IDENT,                     "main" },
+    { CALC_TOKEN_PUNCTOR_ROUND,             "()" },
+    { CALC_TOKEN_PUNCTOR_ARROW_RIGHT,       "->" },
+    { CALC_TOKEN_KEYWORD_INT,               "int" },
+    { CALC_TOKEN_PUNCTOR_CURLY_L,           "{" },
+    { CALC_TOKEN_KEYWORD_LET,               "let" },
+    { CALC_TOKEN_IDENT,                     "x" },
+    { CALC_TOKEN_PUNCTOR_COLON_EQUAL,       ":=" },
+    { CALC_TOKEN_LITERAL_INTEGER_HEX,       "0x1F" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_INTEGER_BIN,       "0b101" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_INTEGER_OCT,       "0c17" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_INTEGER_DEC,       "0d42" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_INTEGER_DEC,       "42" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_FLOAT_DEC,         "3.14" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_FLOAT_DEC,         ".5" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_FLOAT_HEX,         "0x.8" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT,                     "x" },
+    { CALC_TOKEN_PUNCTOR_GREAT_GREAT,       ">>" },
+    { CALC_TOKEN_PUNCTOR_EQUAL,             "=" },
+    { CALC_TOKEN_LITERAL_INTEGER_DEC,       "1" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT,                     "x" },
+    { CALC_TOKEN_PUNCTOR_QUEST_QUEST,       "??" },
+    { CALC_TOKEN_IDENT,                     "y" },
+    { CALC_TOKEN_PUNCTOR_QUEST_POINT,       "?." },
+    { CALC_TOKEN_IDENT,                     "z" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT,                     "a" },
+    { CALC_TOKEN_PUNCTOR_ELLIP,             "..." },
+    { CALC_TOKEN_IDENT,                     "b" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_LITERAL_INTEGER_DEC,       "0" },
+    { CALC_TOKEN_PUNCTOR_POINT_POINT,       ".." },
+    { CALC_TOKEN_LITERAL_INTEGER_DEC,       "9" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_LITERAL_INTEGER_DEC,       "12" },
+    { CALC_TOKEN_PUNCTOR_POINT,             "." },
+    { CALC_TOKEN_IDENT,                     "x" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT,                     "long_identifier_longer_than_the_32_bytes_of_a_block_\xC3\xA8" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT,                     "c" },
+    { CALC_TOKEN_PUNCTOR_EQUAL,             "=" },
+    { CALC_TOKEN_LITERAL_CHAR,              "'a'" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_CHAR_ESC,          "'\\n'" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_CHAR_OCT,          "'\\101'" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_CHAR_HEX,          "'\\x41'" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_CHAR_UNI,          "'\\u20AC'" },
+    { CALC_TOKEN_PUNCTOR_PLUSS,             "+" },
+    { CALC_TOKEN_LITERAL_CHAR,              "'\xC3\xA0'" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT_OR_KWORD,            "this" },
+    { CALC_TOKEN_PUNCTOR_POINT,             "." },
+    { CALC_TOKEN_IDENT_OR_KWORD,            "get" },
+    { CALC_TOKEN_PUNCTOR_EQUAL,             "=" },
+    { CALC_TOKEN_LITERAL_STRING,            "\"str \\\" \xE2\x82\xAC\"" },
+    { CALC_TOKEN_PUNCTOR_SEMIC,             ";" },
+    { CALC_TOKEN_IDENT,                     "\xCE\xBB_1" },
+    { CALC_TOKEN_INVALID,                   "$" },
+    { CALC_TOKEN_INVALID,                   "\"unterminated" },
+    { CALC_TOKEN_PUNCTOR_CURLY_R,           "}" },
+    { CALC_TOKEN_TRIVIAL_ENDOF,             "" },
+};
+
+static CalcToken_t tokens[COUNT];
+static char lexemes[COUNT][64];
+static size_t length;
+
+static size_t CALC_STDCALL readText(void *context, byte_t *buffer, size_t count)
+{
+    Text_t *text = (Text_t *)context;
+
+    count = min(count, strlen(text->data + text->position));
+    memcpy(buffer, text->data + text->position, count);
+    text->position += count;
+
+    return count;
+}
+
+// Scans all the tokens of a stream, storing them (lexemes are copied, they
+// don't outlive the next token).
+static size_t scan(CalcSourceStream_t *const s, CalcToken_t *const outTokens, char (*const outLexemes)[64])
+{
+    CalcLexer_t *lexer = calcCreateLexer(s);
+    size_t count = 0;
+
+    do
+    {
+        calcLexerNextToken(lexer, &outTokens[count]);
+
+        memcpy(outLexemes[count], outTokens[count].lexeme.data, min(outTokens[count].lexeme.length, 63));
+        outLexemes[count][min(outTokens[count].lexeme.length, 63)] = NUL;
+    } while ((outTokens[count++].code != CALC_TOKEN_TRIVIAL_ENDOF) && (count < COUNT));
+
+    calcDeleteLexer(lexer);
+    calcDeleteSourceStream(s);
+
+    return count;
+}
+
+// Scans the text from an open stream, refilled 16 bytes at a time (so that
+// lexemes span many refills), and compares its tokens with the ones scanned
+// from the whole text.
+static int compare(const char *const data)
+{
+    static CalcToken_t other[COUNT];
+    static char otherLexemes[COUNT][64];
+
+    CalcSourceStream_t *s;
+    Text_t text;
+    size_t count, i;
+
+    int failed = 0;
+
+    length = scan(calcCreateSourceStreamFromText(data, CALC_SOURCE_ENCODING_UTF_8), tokens, lexemes);
+
+    text.data = data, text.position = 0;
+    s = calcOpenSourceStreamFromReader("<text>", readText, &text, CALC_SOURCE_ENCODING_UTF_8);
+    calcSetSourceStreamRefillSize(s, 16);
+
+    failed |= ((count = scan(s, other, otherLexemes)) != length);
+
+    for (i = 0; !failed && (i < count); i++)
+    {
+        failed |= (other[i].code != tokens[i].code) || strcmp(otherLexemes[i], lexemes[i]);
+        failed |= (other[i].loc != tokens[i].loc);
+    }
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceManager_t *m;
+    CalcSourceEntry_t *e;
+    CalcLexer_t *lexer;
+    CalcSourceLine_t l;
+    CalcToken_t token;
+    const char *path;
+    size_t i;
+
+    int failed = 0;
+
+    failed |= compare(source);
+    failed |= (length != (sizeof(expected) / sizeof(*expected)));
+
+    for (i = 0; !failed && (i < length); i++)
+    {
+        failed |= (tokens[i].code != expected[i].code) || strcmp(lexemes[i], expected[i].lexeme);
+
+        if (failed)
+            printf("token %u: %d '%s'\n", (unsigned)i, tokens[i].code, lexemes[i]);
+    }
+
+    // Tokens with a fixed lexeme match it.
+    failed |= compare((const char *)b->data);
+
+    for (i = 0; i < length; i++)
+        failed |= (calcGetTokenLexeme(tokens[i].code) != NULL) && strcmp(calcGetTokenLexeme(tokens[i].code), lexemes[i]) && (tokens[i].code < CALC_TOKEN_DIRECTIVE_CASE || tokens[i].code > CALC_TOKEN_DIRECTIVE_UNDEF);
+
+    // Locations point to the first byte of each token.
+    failed |= (tokens[0].loc != (CALC_SOURCE_INVALID_LOC + 1)) || ((tokens[1].loc - tokens[0].loc) != 4);
+
+    // Tokens of the sources of a manager are decoded to their files and lines.
+    m = calcCreateSourceManager();
+    calcSourceManagerAdd(m, "<first>", FALSE, calcCreateSourceBufferFromText("first"));
+    e = calcSourceManagerAdd(m, "<second>", FALSE, calcCreateSourceBufferFromText("let a;\n  b"));
+    lexer = calcCreateLexer(calcSourceManagerCreateStream(e));
+
+    for (i = 0; i < 4; i++)
+        calcLexerNextToken(lexer, &token);
+
+    failed |= (token.code != CALC_TOKEN_IDENT) || !calcSourceManagerDecode(m, token.loc, &path, &l) || strcmp(path, "<second>") || (l.ln != 1) || (l.co != 2);
+
+    calcDeleteSourceStream(lexer->sourceStream);
+    calcDeleteLexer(lexer);
+    calcDeleteSourceManager(m);
+
+    calcDeleteSourceBuffer(b);
+
+    return failed;
+}
@@ -0,0 +1,131 @@
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+#include "calc/lex/token_buffer.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define COPIES 64
+
+// Lines with block comments that span many chunks, unterminated comments and
+// literals, and comment ends inside strings.
+static const char *const lines[] = {
+    "let s = \"/* not a comment */\"; // neither /* this\n",
+    "/* a block comment\n",
+    "   that spans * many / lines\n",
+    "   let x = \"*/\" -- it ends in here\n",
+    "fn f(a : int) -> int = a /* short */ * 2;\n",
+    "\n",
+    "    \t\n",
+    "let t = 'x' + \"unterminated\n",
+    "a / * b /\n",
+    "*/ x := /**/ 1; /* until\n",
+    "\n",
+    "the end */ y\n",
+};
+
+// Scans the source sequentially and in parallel with the specified chunk
+// size, comparing the tokens.
+static int compare(const CalcSourceBuffer_t *const b, size_t chunkSize, size_t threadCount)
+{
+    CalcSourceStream_t *s = calcCreateSourceStreamFromText((const char *)b->data, CALC_SOURCE_ENCODING_UTF_8);
+    CalcTokenBuffer_t *sequential = calcCreateTokenBuffer(s->buffer, 0), *parallel = calcCreateTokenBuffer(s->buffer, 0);
+    CalcLexer_t *lexer = calcCreateLexer(s);
+
+    int failed = 0;
+
+    failed |= !calcTokenBufferScan(sequential, lexer);
+    failed |= (calcTokenBufferScanParallel(parallel, chunkSize, threadCount) != sequential->count);
+
+    if (!failed)
+    {
+        failed |= memcmp(parallel->codes, sequential->codes, sequential->count * sizeof(CalcTokenCode_t)) != 0;
+        failed |= memcmp(parallel->offsets, sequential->offsets, sequential->count * sizeof(uint32_t)) != 0;
+        failed |= memcmp(parallel->lengths, sequential->lengths, sequential->count * sizeof(uint32_t)) != 0;
+    }
+
+    if (failed)
+        printf("chunk size %u, %u threads: failed\n", (unsigned)chunkSize, (unsigned)threadCount);
+
+    calcDeleteLexer(lexer);
+    calcDeleteTokenBuffer(parallel);
+    calcDeleteTokenBuffer(sequential);
+    calcDeleteSourceStream(s);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *p = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8), *b;
+    size_t size = 0, i, j;
+    char *text;
+
+    int failed = 0;
+
+    text = (char *)cmalloc((COPIES * (p->size + 1024)) + 1);
+
+    for (i = 0; i < COPIES; i++)
+    {
+        for (j = 0; j < (sizeof(lines) / sizeof(*lines)); j++)
+        {
+            if (((i + j) % 3) || (j == 1))
+            {
+                memcpy(text + size, lines[j], strlen(lines[j]));
+                size += strlen(lines[j]);
+            }
+        }
+
+        memcpy(text + size, p->data, p->size - 1);
+        size += p->size - 1;
+    }
+
+    text[size] = NUL;
+
+    b = calcCreateSourceBufferFromText(text);
+
+    for (i = 1; i < 4096; i = (i * 3) + 1)
+        failed |= compare(b, i, 4);
+
+    failed |= compare(b, 0, 0);
+    failed |= compare(b, 64, 1);
+
+    // Unterminated comments go on up to the end of the source.
+    calcDeleteSourceBuffer(b);
+    b = calcCreateSourceBufferFromText("x /* unterminated\ncomment\n\n");
+
+    failed |= compare(b, 1, 4);
+
+    // Stray comment openings are '/' tokens, unless a '*/' follows them in
+    // some later chunk.
+    for (i = 0, size = 0; i < 1024; i++)
+    {
+        memcpy(text + size, "a /* b /\n", 9);
+        size += 9;
+    }
+
+    text[size] = NUL;
+
+    calcDeleteSourceBuffer(b);
+    b = calcCreateSourceBufferFromText(text);
+
+    failed |= compare(b, 64, 4);
+
+    memcpy(text + size, "*/ c\n", 6);
+    text[size + 6] = NUL;
+
+    calcDeleteSourceBuffer(b);
+    b = calcCreateSourceBufferFromText(text);
+
+    failed |= compare(b, 64, 4);
+
+    calcDeleteSourceBuffer(b);
+    b = calcCreateSourceBufferFromText("");
+
+    failed |= compare(b, 1, 4);
+
+    calcDeleteSourceBuffer(b);
+    calcDeleteSourceBuffer(p);
+    free(text);
+
+    return failed;
+}
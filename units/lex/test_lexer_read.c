@@ -0,0 +1,82 @@
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+#include "calc/lex/lexer.h"
+
+#include <time.h>
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define CORPUS_SIZE (64 * 1024 * 1024)
+
+// Repeats the content of a buffer up to the size of the corpus, at the end of
+// a line.
+static char *makeCorpus(const CalcSourceBuffer_t *const b, size_t *const outSize)
+{
+    char *corpus = (char *)cmalloc(CORPUS_SIZE + b->size + 1);
+    size_t size = 0, n = strlen((const char *)b->data);
+
+    while (size < CORPUS_SIZE)
+    {
+        memcpy(corpus + size, b->data, n);
+        size += n;
+        corpus[size++] = EOL;
+    }
+
+    corpus[size] = NUL;
+
+    *outSize = size;
+
+    return corpus;
+}
+
+// Scans all the tokens of the corpus.
+static double scan(const char *const corpus, size_t size, bool_t isLazy, size_t *const outCount)
+{
+    CalcSourceStream_t *s = calcCreateSourceStreamFromText(corpus, CALC_SOURCE_ENCODING_UTF_8);
+    CalcLexer_t *lexer = calcCreateLexer(s);
+    CalcToken_t token;
+    size_t count = 0;
+
+    double T1, T2;
+
+    calcSetSourceStreamLazyLocations(s, isLazy);
+
+    T1 = (double)clock() / CLOCKS_PER_SEC;
+
+    while (calcLexerNextToken(lexer, &token) != CALC_TOKEN_TRIVIAL_ENDOF)
+        count++;
+
+    T2 = (double)clock() / CLOCKS_PER_SEC;
+
+    calcDeleteLexer(lexer);
+    calcDeleteSourceStream(s);
+
+    *outCount = count;
+
+    return (size / 1048576.0) / (T2 - T1);
+}
+
+int main()
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    size_t size, count;
+    char *corpus;
+
+    double speed;
+
+    if (!b)
+        return 1;
+
+    corpus = makeCorpus(b, &size);
+
+    speed = scan(corpus, size, FALSE, &count);
+    printf("calcLexerNextToken:   %8.2f MB/s (%u tokens)\n", speed, (unsigned)count);
+
+    speed = scan(corpus, size, TRUE, &count);
+    printf("lazy locations:       %8.2f MB/s (%u tokens)\n", speed, (unsigned)count);
+
+    free(corpus);
+    calcDeleteSourceBuffer(b);
+
+    return 0;
+}
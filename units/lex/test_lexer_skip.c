@@ -0,0 +1,124 @@
+#include "calc/base/alloc.h"
+#include "calc/base/file.h"
+#include "calc/base/scan.h"
+#include "calc/base/string.h"
+
+#include <ctype.h>
+#include <time.h>
+
+#define CORPUS_SIZE (16 * 1024 * 1024)
+
+#define ROUNDS 8
+
+typedef size_t (CALC_STDCALL *Kernel_t)(const byte_t *const buf, size_t count);
+
+static size_t CALC_STDCALL loopBlanks(const byte_t *const buf, size_t count)
+{
+    size_t i;
+
+    for (i = 0; (i < count) && ((buf[i] == ' ') || ((buf[i] >= '\t') && (buf[i] <= '\r'))); i++)
+        ;
+
+    return i;
+}
+
+static size_t CALC_STDCALL loopIdent(const byte_t *const buf, size_t count)
+{
+    size_t i;
+
+    for (i = 0; (i < count) && (isalnum(buf[i]) || (buf[i] == '_') || (buf[i] & 0x80)); i++)
+        ;
+
+    return i;
+}
+
+static size_t CALC_STDCALL loopComment(const byte_t *const buf, size_t count)
+{
+    size_t i;
+
+    for (i = 0; (i < count) && (buf[i] != EOL); i++)
+        ;
+
+    return i;
+}
+
+static size_t CALC_STDCALL kernelComment(const byte_t *const buf, size_t count)
+{
+    return bufuntil(buf, count, EOL);
+}
+
+// Fills the corpus with runs of the bytes of a class, of lengths from 1 to
+// 64, each one ended by a byte out of it.
+static byte_t *makeCorpus(const char *const run, char end)
+{
+    byte_t *corpus = (byte_t *)cmalloc(CORPUS_SIZE);
+    size_t i = 0, n, j;
+
+    srand(42);
+
+    while ((i + 65) < CORPUS_SIZE)
+    {
+        for (n = 1 + (rand() % 64), j = 0; j < n; j++)
+            corpus[i++] = (byte_t)run[rand() % strlen(run)];
+
+        corpus[i++] = (byte_t)end;
+    }
+
+    while (i < CORPUS_SIZE)
+        corpus[i++] = (byte_t)end;
+
+    return corpus;
+}
+
+// Skips all the runs of the corpus, returning the speed of the kernel.
+static double skip(Kernel_t kernel, const byte_t *const corpus, size_t *const outTotal)
+{
+    size_t i, n, total = 0, round;
+
+    double T1, T2;
+
+    T1 = (double)clock() / CLOCKS_PER_SEC;
+
+    for (round = 0; round < ROUNDS; round++)
+    {
+        for (i = 0; i < CORPUS_SIZE; i++)
+        {
+            n = kernel(corpus + i, CORPUS_SIZE - i);
+            total += n, i += n;
+        }
+    }
+
+    T2 = (double)clock() / CLOCKS_PER_SEC;
+
+    *outTotal = total;
+
+    return ((CORPUS_SIZE / 1048576.0) * ROUNDS) / (T2 - T1);
+}
+
+static int compare(const char *const name, Kernel_t loop, Kernel_t kernel, const char *const run, char end)
+{
+    byte_t *corpus = makeCorpus(run, end);
+    size_t loopTotal, kernelTotal;
+
+    double loopSpeed, kernelSpeed;
+
+    loopSpeed = skip(loop, corpus, &loopTotal);
+    kernelSpeed = skip(kernel, corpus, &kernelTotal);
+
+    printf("%-10s loop: %8.2f MB/s, kernel: %8.2f MB/s\n", name, loopSpeed, kernelSpeed);
+
+    free(corpus);
+
+    return (loopTotal != kernelTotal);
+}
+
+int main()
+{
+    int failed = 0;
+
+    failed |= compare("blanks", loopBlanks, bufblanks, " \t\n\r\v\f", 'x');
+    failed |= compare("ident", loopIdent, bufident, "abcxyzABCXYZ_0123456789\xC3\xA0", '.');
+    failed |= compare("comment", loopComment, kernelComment, "abc ;/*+-()\t\xE2\x82\xAC", EOL);
+
+    return failed;
+}
@@ -0,0 +1,91 @@
+#include "calc/base/string.h"
+#include "calc/lex/token_buffer.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define SIZE 2048
+
+int main()
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceStream_t *s = calcCreateSourceStreamFromFile(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceStream_t *r, *t = calcCreateSourceStreamFromText("a", CALC_SOURCE_ENCODING_UTF_8);
+    CalcTokenBuffer_t *tb;
+    CalcLexer_t *lexer;
+    CalcSourceSpan_t lexeme;
+    CalcToken_t token;
+    char text[SIZE];
+    size_t count, i;
+
+    int failed = 0;
+
+    // The buffer starts small, so it grows many times.
+    tb = calcCreateTokenBuffer(s->buffer, 4);
+    lexer = calcCreateLexer(s);
+    count = calcTokenBufferScan(tb, lexer);
+
+    calcDeleteLexer(lexer);
+
+    failed |= (count == 0) || (count != tb->count) || (tb->codes[count - 1] != CALC_TOKEN_TRIVIAL_ENDOF);
+
+    // The stored tokens are the ones scanned by the lexer, the lexemes are
+    // still in the buffer of the scanned stream.
+    r = calcCreateSourceStreamFromFile(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8);
+    lexer = calcCreateLexer(r);
+
+    for (i = 0; !failed && (i < count); i++)
+    {
+        calcLexerNextToken(lexer, &token);
+        calcTokenBufferGetLexeme(tb, i, &lexeme);
+
+        failed |= (tb->codes[i] != token.code) || (lexeme.length != token.lexeme.length) || (tb->offsets[i] != (token.loc - r->base));
+        failed |= (token.lexeme.length && memcmp(lexeme.data, token.lexeme.data, lexeme.length));
+    }
+
+    calcDeleteLexer(lexer);
+    calcDeleteTokenBuffer(tb);
+    calcDeleteSourceStream(r);
+
+    // A source past the offset limit (set small for this test): the tokens
+    // before the first one out of it are dropped and the buffer is left as it
+    // was, while a parallel scan doesn't begin.
+    calcDeleteSourceStream(s);
+    memset(text, ' ', SIZE - 1);
+    text[SIZE - 1] = '\0';
+
+    for (i = 0; i < (SIZE - 1); i += 2)
+        text[i] = 'a';
+
+    s = calcCreateSourceStreamFromText(text, CALC_SOURCE_ENCODING_UTF_8);
+
+    tb = calcCreateTokenBuffer(s->buffer, 0);
+    calcTokenBufferPush(tb, CALC_TOKEN_IDENT, 0, 1);
+    lexer = calcCreateLexer(s);
+
+    failed |= (calcTokenBufferScan(tb, lexer) != 0) || (tb->count != 1);
+    failed |= (calcTokenBufferScanParallel(tb, 0, 0) != 0) || (tb->count != 1);
+
+    calcDeleteLexer(lexer);
+    calcDeleteTokenBuffer(tb);
+
+    // Streams of other buffers can't be scanned.
+    tb = calcCreateTokenBuffer(b, 0);
+    lexer = calcCreateLexer(t);
+
+    failed |= (calcTokenBufferScan(tb, lexer) != 0) || (tb->count != 0);
+
+    calcTokenBufferPush(tb, CALC_TOKEN_IDENT, 4, 5);
+    calcTokenBufferGetLexeme(tb, 0, &lexeme);
+    failed |= (tb->count != 1) || (lexeme.data != (b->data + 4)) || (lexeme.length != 5);
+
+    calcClearTokenBuffer(tb);
+    failed |= (tb->count != 0) || (tb->capacity != CALC_TOKEN_BUFFER_CAPACITY);
+
+    calcDeleteLexer(lexer);
+    calcDeleteTokenBuffer(tb);
+    calcDeleteSourceStream(t);
+    calcDeleteSourceStream(s);
+    calcDeleteSourceBuffer(b);
+
+    return failed;
+}
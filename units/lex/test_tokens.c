@@ -1,12 +1,44 @@
 #include "calc/lex/tokens.h"
 
 #include <stdio.h>
+#include <string.h>
+
+// The keywords defined in tokens.inc.
+static const CalcTokenCode_t keywords[] = {
+#define calcDefineToken(name)
+#define calcDefineTokenWithLexeme(name, lexeme)
+#define calcDefineKeywordToken(name, lexeme) name,
+
+#include CALC_LEX_TOKENS_INC_
+
+#undef calcDefineToken
+};
+
+static const char *const identifiers[] = {
+    "x", "main", "asyncs", "Auto", "lets", "i", "fnn", "prox", "gets", "thisx", "defines", "_if", "whilst",
+};
 
 int main()
 {
     const char *lexeme = calcGetTokenLexeme(CALC_TOKEN_KEYWORD_TEMPLATE);
+    size_t i;
+
+    int failed = 0;
 
     printf("%s\n", lexeme);
 
-    return 0;
+    // Each keyword is found from its lexeme, and identifiers are not.
+    for (i = 0; i < (sizeof(keywords) / sizeof(*keywords)); i++)
+    {
+        lexeme = calcGetTokenLexeme(keywords[i]);
+        failed |= (calcGetKeywordToken(lexeme, strlen(lexeme)) != keywords[i]);
+    }
+
+    for (i = 0; i < (sizeof(identifiers) / sizeof(*identifiers)); i++)
+        failed |= (calcGetKeywordToken(identifiers[i], strlen(identifiers[i])) != CALC_TOKEN_INVALID);
+
+    // Lexemes are spans, they don't need to be terminated.
+    failed |= (calcGetKeywordToken("letter", 3) != CALC_TOKEN_KEYWORD_LET);
+
+    return failed;
 }
@@ -0,0 +1,106 @@
+#include "calc/base/string.h"
+#include "calc/source/source_stream.h"
+
+#define PERIOD 1024
+
+#define SIZE   ((uint64_t)8 << 30)
+#define BUDGET ((size_t)64 << 20)
+
+typedef struct
+{
+    uint64_t position;
+    uint64_t size;
+    byte_t   pattern[PERIOD];
+} Source_t;
+
+/// @brief Synthesizes the source repeating its pattern, nothing is stored.
+static size_t CALC_STDCALL readSource(void *context, byte_t *buffer, size_t count)
+{
+    Source_t *source = (Source_t *)context;
+    size_t total = 0, offset, chunk;
+
+    while ((total < count) && (source->position < source->size))
+    {
+        offset = (size_t)(source->position % PERIOD);
+        chunk = min(count - total, PERIOD - offset);
+        chunk = (size_t)min((uint64_t)chunk, source->size - source->position);
+
+        memcpy(buffer + total, source->pattern + offset, chunk);
+
+        total += chunk;
+        source->position += chunk;
+    }
+
+    return total;
+}
+
+int main()
+{
+    Source_t source;
+    CalcSourceStream_t *s;
+    size_t total = 0, count;
+
+    int failed = 0;
+
+    // 8 GB made of lines of EOLs, each run followed by an 'x': both the
+    // position and the line number go past 2^32.
+    memset(source.pattern, EOL, PERIOD - 1);
+    source.pattern[PERIOD - 1] = 'x';
+    source.position = 0;
+    source.size = SIZE;
+
+    s = calcOpenSourceStreamFromReader("<synthetic>", readSource, &source, CALC_SOURCE_ENCODING_UTF_8);
+
+    calcSetSourceStreamRefillSize(s, 1 << 20);
+    failed |= !calcSetSourceStreamMemoryBudget(s, BUDGET);
+
+    while (!failed && (calcSourceStreamReadUntil(s, 'x', NULL), calcSourceStreamRead(s) != EOF))
+    {
+        failed |= (s->forwardLocation.co != 1) || (s->buffer->size > BUDGET);
+
+        calcSourceStreamBeginLexeme(s);
+    }
+
+    failed |= (s->forwardLocation.ch != SIZE) || (s->forwardLocation.ln != ((SIZE / PERIOD) * (PERIOD - 1))) || s->isOverflowed;
+
+    calcDeleteSourceStream(s);
+
+    // A lexeme larger than the budget stops the refills, until the next one
+    // begins.
+    memset(source.pattern, 'a', PERIOD);
+    source.position = 0;
+    source.size = 1 << 20;
+
+    s = calcOpenSourceStreamFromReader("<synthetic>", readSource, &source, CALC_SOURCE_ENCODING_UTF_8);
+
+    failed |= !calcSetSourceStreamMemoryBudget(s, 1 << 16);
+
+    count = calcSourceStreamReadWhile(s, CALC_SOURCE_CLASS_IDENTIFIER, NULL);
+    failed |= !s->isOverflowed || (count > (1 << 15)) || (s->buffer->size > (1 << 16));
+
+    calcSourceStreamBeginLexeme(s);
+
+    for (total = count; (count = calcSourceStreamReadWhile(s, CALC_SOURCE_CLASS_IDENTIFIER, NULL)) != 0; total += count)
+        calcSourceStreamBeginLexeme(s);
+
+    failed |= (total != source.size) || (s->forwardLocation.co != source.size);
+
+    calcDeleteSourceStream(s);
+
+    // Streams read without lexemes retain only the bytes from the cursor, so
+    // they stay within the budget.
+    source.position = 0;
+
+    s = calcOpenSourceStreamFromReader("<synthetic>", readSource, &source, CALC_SOURCE_ENCODING_UTF_8);
+
+    failed |= !calcSetSourceStreamMemoryBudget(s, 1 << 16);
+
+    for (total = 0; calcSourceStreamRead(s) != EOF; total++)
+        failed |= s->isOverflowed;
+
+    failed |= (total != source.size) || (s->buffer->size > (1 << 16));
+
+    calcDeleteSourceStream(s);
+
+    return failed;
+}
@@ -0,0 +1,95 @@
+#include "calc/source/source_cache.h"
+
+#include <time.h>
+
+#define PATH CALC_TEMP_PATH "/test_source_cache.calc"
+#define COPY CALC_TEMP_PATH "/test_source_cache_copy.calc"
+
+static int deleted = 0;
+
+static void CALC_STDCALL deleteArtifact(void *artifact)
+{
+    deleted++, (void)artifact;
+}
+
+static void writeFile(const char *const path, const char *const text)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (f)
+    {
+        fputs(text, f);
+        fclose(f);
+    }
+}
+
+int main()
+{
+    static const byte_t expected[CALC_SHA256_BLOCK_SIZE] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+
+    CalcSourceCache_t *c = calcCreateSourceCache();
+    CalcSourceCacheEntry_t *e, *f;
+    CalcSourceBuffer_t *b;
+
+    int failed = 0;
+
+    writeFile(PATH, "abc");
+
+    // First lookup: the file is read and fingerprinted (SHA-256 of "abc").
+    failed |= !(e = calcSourceCacheLookup(c, PATH, &b)) || !b || !bufcmp(e->hash, expected, CALC_SHA256_BLOCK_SIZE);
+
+    if (failed)
+    {
+        calcDeleteSourceCache(c);
+        remove(PATH);
+
+        return failed;
+    }
+
+    failed |= (b->size != 4) || strcmp((const char *)b->data, "abc") || b->isMapped;
+
+    calcDeleteSourceBuffer(b);
+    calcSourceCacheSetArtifact(e, (void *)c, deleteArtifact);
+
+    // Unchanged metadata: the file is not read.
+    failed |= (calcSourceCacheLookup(c, PATH, &b) != e) || b || (e->artifact->data != (void *)c);
+
+    // Touched but unchanged content: the artifact survives.
+    e->mtime++;
+    failed |= (calcSourceCacheLookup(c, PATH, &b) != e) || !b || (e->artifact->data != (void *)c) || deleted;
+
+    calcDeleteSourceBuffer(b);
+
+    // Changed content: the artifact is released.
+    writeFile(PATH, "abd");
+    e->mtime++;
+    failed |= (calcSourceCacheLookup(c, PATH, NULL) != e) || e->artifact->data || (deleted != 1) || bufcmp(e->hash, expected, CALC_SHA256_BLOCK_SIZE);
+
+    failed |= calcSourceCacheLookup(c, PATH ".missing", NULL) != NULL;
+
+    // Another path with the same bytes shares the artifact, that's kept
+    // until no file has that content.
+    writeFile(COPY, "abd");
+    failed |= !(f = calcSourceCacheLookup(c, COPY, NULL)) || (f == e) || (f->artifact != e->artifact) || (c->count != 2) || (c->artifactCount != 1);
+
+    if (!failed)
+    {
+        calcSourceCacheSetArtifact(e, (void *)c, deleteArtifact);
+        failed |= f->artifact->data != (void *)c;
+
+        writeFile(PATH, "abc");
+        e->mtime++;
+        failed |= (calcSourceCacheLookup(c, PATH, NULL) != e) || (e->artifact == f->artifact) || (f->artifact->data != (void *)c) || (c->artifactCount != 2) || (deleted != 1);
+    }
+
+    calcDeleteSourceCache(c);
+    failed |= deleted != 2;
+
+    remove(PATH);
+    remove(COPY);
+
+    return failed;
+}
@@ -0,0 +1,119 @@
+#include "calc/base/string.h"
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define COPIES 64
+
+#define LONG 20000
+
+static int32_t first[LONG], second[LONG];
+
+typedef struct _Text
+{
+    const byte_t *data;
+    size_t        size;
+    size_t        position;
+} Text_t;
+
+static size_t CALC_STDCALL readText(void *context, byte_t *buffer, size_t count)
+{
+    Text_t *text = (Text_t *)context;
+
+    count = min(count, text->size - text->position);
+    memcpy(buffer, text->data + text->position, count);
+    text->position += count;
+
+    return count;
+}
+
+// Speculates over count characters (beyond the refill size), rewinds and reads
+// them again, nesting a second speculation.
+static int speculate(CalcSourceStream_t *const s, size_t count)
+{
+    CalcSourceCheckpoint_t outer, inner;
+    CalcSourceLocation_t location;
+    size_t i;
+
+    int failed = 0;
+
+    calcSourceStreamCheckpoint(s, &outer);
+    location = s->forwardLocation;
+
+    for (i = 0; i < count; i++)
+    {
+        first[i] = calcSourceStreamRead(s);
+        calcSourceStreamBeginLexeme(s);
+
+        if (i == (count >> 1))
+            calcSourceStreamCheckpoint(s, &inner);
+    }
+
+    calcSourceStreamRewind(s, &inner);
+    failed |= calcSourceStreamPeek(s) != first[(count >> 1) + 1];
+    calcSourceStreamReleaseCheckpoint(s, &inner);
+
+    calcSourceStreamRewind(s, &outer);
+    failed |= (s->forwardLocation.ch != location.ch) || (s->forwardLocation.ln != location.ln) || (s->forwardLocation.co != location.co);
+
+    // Lookahead and spans see the restored cursor too.
+    failed |= (calcSourceStreamPeekOffset(s, 1) != first[1]);
+
+    for (i = 0; i < count; i++)
+        second[i] = calcSourceStreamRead(s), calcSourceStreamBeginLexeme(s);
+
+    calcSourceStreamReleaseCheckpoint(s, &outer);
+
+    return failed || memcmp(first, second, count * sizeof(int32_t)) || s->checkpointCount;
+}
+
+static int check(CalcSourceStream_t *const s, const Text_t *const text)
+{
+    // The first speculation is longer than the ring, that must grow.
+    int failed = speculate(s, LONG);
+
+    while (!failed && (calcSourceStreamPeek(s) > 0))
+        failed |= speculate(s, 3 + (size_t)(s->forwardLocation.ch % 200));
+
+    // Every byte has been read once from the source.
+    failed |= text && (text->position != text->size);
+    failed |= (calcSourceStreamPeek(s) > 0);
+
+    calcDeleteSourceStream(s);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *p = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceBuffer_t *b = calcCreateSourceBuffer(((p->size - 1) * COPIES) + 1, NULL, 0);
+    CalcSourceStream_t *s;
+    Text_t text;
+    size_t i;
+
+    int failed = 0;
+
+    // The source is larger than the ring, so its bytes are overwritten unless
+    // they're pinned.
+    for (i = 0; i < COPIES; i++)
+        memcpy(b->data + (i * (p->size - 1)), p->data, p->size - 1);
+
+    text.data = b->data, text.size = b->size - 1, text.position = 0;
+    s = calcOpenSourceStreamFromReader("<text>", readText, &text, CALC_SOURCE_ENCODING_UTF_8);
+    calcSetSourceStreamRefillSize(s, 16);
+    failed |= check(s, &text);
+
+    text.position = 0;
+    s = calcOpenSourceStreamFromReader("<text>", readText, &text, CALC_SOURCE_ENCODING_UTF_8);
+    calcSetSourceStreamRefillSize(s, 16);
+    calcSetSourceStreamLazyLocations(s, TRUE);
+    failed |= check(s, &text);
+
+    failed |= check(calcCreateSourceStreamFromText((const char *)b->data, CALC_SOURCE_ENCODING_UTF_8), NULL);
+
+    calcDeleteSourceBuffer(b);
+    calcDeleteSourceBuffer(p);
+
+    return failed;
+}
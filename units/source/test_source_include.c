@@ -0,0 +1,104 @@
+#include "calc/base/path.h"
+#include "calc/base/string.h"
+#include "calc/source/source_include.h"
+
+static const char *const names[] = {
+    "test_source_include_once.tmp",
+    "test_source_include_guard.tmp",
+    "test_source_include_plain.tmp",
+};
+
+static char paths[countof(names)][512];
+
+static void save(size_t index, const char *const content)
+{
+    FILE *f;
+
+    sprintf(paths[index], "%s/%s", CALC_TEMP_PATH, names[index]);
+
+    if ((f = fopen(paths[index], "wb")))
+    {
+        fputs(content, f);
+        fclose(f);
+    }
+}
+
+static bool_t CALC_STDCALL isNotDefined(void *context, const char *name)
+{
+    (void)context, (void)name;
+
+    return FALSE;
+}
+
+int main()
+{
+    char searchPaths[512], other[512];
+    CalcSourceIncludeCache_t *c;
+    CalcSourceInclude_t *once, *guard, *plain, *i;
+    size_t n, probes;
+
+    int failed = 0;
+
+    save(0, "// A header.\n#pragma once\nlet a = 1;\n");
+    save(1, "/* A guarded header. */\n#ifndef GUARD_H\n#define GUARD_H\n#if X\n#endif\nlet b = 2;\n#endif // GUARD_H\n");
+    save(2, "#ifndef P\n#define P\n#endif\nlet c = 3;\n");
+
+    sprintf(searchPaths, "missing%c%s", CALC_PATHSEP, CALC_TEMP_PATH);
+
+    c = calcCreateSourceIncludeCache(searchPaths);
+    failed |= (c->pathCount != 2) || strcmp(c->paths[0], "missing") || strcmp(c->paths[1], CALC_TEMP_PATH);
+
+    once = calcSourceIncludeCacheResolve(c, names[0], NULL);
+    guard = calcSourceIncludeCacheResolve(c, names[1], NULL);
+    plain = calcSourceIncludeCacheResolve(c, names[2], NULL);
+    probes = c->probes;
+
+    failed |= !once || !guard || !plain || (c->loads != 3) || (probes != 6);
+    failed |= failed || !once->isOnce || once->guard || guard->isOnce || !guard->guard || strcmp(guard->guard, "GUARD_H") || plain->isOnce || plain->guard;
+    failed |= failed || strcmp((const char *)guard->buffer->data + 24, "#ifndef GUARD_H\n#define GUARD_H\n#if X\n#endif\nlet b = 2;\n#endif // GUARD_H\n");
+
+    // Resolved names are neither searched nor loaded again.
+    for (n = 0; !failed && (n < 1000); n++)
+        failed |= (calcSourceIncludeCacheResolve(c, names[n % 3], NULL) != ((n % 3) ? ((n % 3) == 1 ? guard : plain) : once));
+
+    failed |= (c->loads != 3) || (c->probes != probes);
+
+    // The same file reached from another directory is the same include.
+    failed |= (calcSourceIncludeCacheResolve(c, names[0], CALC_TEMP_PATH "/main.calc") != once) || (c->loads != 3) || (c->probes != (probes + 1));
+    failed |= calcSourceIncludeCacheResolve(c, "test_source_include_missing.tmp", CALC_TEMP_PATH "/main.calc") != NULL;
+
+    // So is the same file reached through another spelling of its path: a
+    // file marked with '#pragma once' is lexed once.
+    sprintf(other, "../tmp/%s", names[0]);
+    failed |= (calcSourceIncludeCacheResolve(c, other, CALC_TEMP_PATH "/main.calc") != once) || (c->loads != 3);
+
+    if (!failed)
+    {
+        failed |= !calcSourceIncludeCacheEnter(c, once, NULL, NULL) || calcSourceIncludeCacheEnter(c, once, NULL, NULL);
+        failed |= !calcSourceIncludeCacheEnter(c, guard, NULL, NULL) || calcSourceIncludeCacheEnter(c, guard, NULL, NULL);
+        failed |= !calcSourceIncludeCacheEnter(c, guard, isNotDefined, NULL);
+        failed |= !calcSourceIncludeCacheEnter(c, plain, NULL, NULL) || !calcSourceIncludeCacheEnter(c, plain, NULL, NULL);
+
+        calcSourceIncludeCacheBeginUnit(c);
+        failed |= !calcSourceIncludeCacheEnter(c, once, NULL, NULL) || calcSourceIncludeCacheEnter(c, once, NULL, NULL);
+    }
+
+    // A file rewritten with the same content keeps its include.
+    save(0, "// A header.\n#pragma once\nlet a = 1;\n");
+    failed |= (calcSourceIncludeCacheResolve(c, names[0], NULL) != once) || (c->loads != 3);
+
+    // A modified file is loaded in a new include, while the superseded one
+    // keeps its content.
+    save(2, "let c = 33;\n");
+    i = calcSourceIncludeCacheResolve(c, names[2], NULL);
+    failed |= !i || (i == plain) || (c->loads != 4) || strcmp((const char *)i->buffer->data, "let c = 33;\n");
+    failed |= strcmp((const char *)plain->buffer->data, "#ifndef P\n#define P\n#endif\nlet c = 3;\n");
+    failed |= (calcSourceIncludeCacheResolve(c, names[2], CALC_TEMP_PATH "/main.calc") != i) || (c->loads != 4);
+
+    calcDeleteSourceIncludeCache(c);
+
+    for (n = 0; n < countof(names); n++)
+        remove(paths[n]);
+
+    return failed;
+}
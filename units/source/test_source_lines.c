@@ -0,0 +1,22 @@
+#include "calc/source/source_lines.h"
+
+int main()
+{
+    CalcSourceBuffer_t *s = calcCreateSourceBufferFromText("let x = 1;\n\nlet yy = x;\nlast");
+    CalcSourceLine_t l;
+
+    int failed = 0;
+
+    failed |= !calcSourceBufferFindLine(s, 0, &l) || (l.ln != 0) || (l.co != 0) || (l.length != 10);
+    failed |= !calcSourceBufferFindLine(s, 10, &l) || (l.ln != 0) || (l.co != 10);
+    failed |= !calcSourceBufferFindLine(s, 11, &l) || (l.ln != 1) || (l.co != 0) || (l.length != 0);
+    failed |= !calcSourceBufferFindLine(s, 16, &l) || (l.ln != 2) || (l.co != 4) || strncmp((const char *)l.text, "let yy = x;", l.length) || (l.length != 11);
+    failed |= !calcSourceBufferFindLine(s, 26, &l) || (l.ln != 3) || (l.co != 2) || (l.length != 4);
+    failed |= !calcSourceBufferFindLine(s, 28, &l) || (l.ln != 3) || (l.co != 4);
+    failed |= calcSourceBufferFindLine(s, 29, &l);
+    failed |= (calcGetSourceLines(s)->count != 4);
+
+    calcDeleteSourceBuffer(s);
+
+    return failed;
+}
@@ -0,0 +1,81 @@
+#include "calc/source/source_loader.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define TEMP(name) CALC_TEMP_PATH "/test_source_loader_" name ".tmp"
+
+#define COUNT 256
+
+static char names[COUNT][512];
+
+static int check(const char *const *const paths, size_t threadCount, const CalcSourceBuffer_t *const point)
+{
+    CalcSourceBuffer_t **b = calcLoadSourceBuffers(paths, COUNT + 5, threadCount, CALC_SOURCE_ENCODING_UTF_8);
+    char expected[32];
+    size_t i;
+
+    int failed = 0;
+
+    // The buffers are in the order of the paths, whichever thread loaded them.
+    for (i = 0; i < COUNT; i++)
+    {
+        sprintf(expected, "let x%u = %u;\n", (unsigned)i, (unsigned)(i * i));
+        failed |= !b[i] || strcmp((const char *)b[i]->data, expected) || !b[i]->isValidated;
+    }
+
+    failed |= (b[COUNT] != NULL) || (b[COUNT + 1] != NULL);
+    failed |= !b[COUNT + 2] || (b[COUNT + 2]->size != point->size) || memcmp(b[COUNT + 2]->data, point->data, point->size);
+    failed |= (b[COUNT + 3] != NULL);
+    failed |= !b[COUNT + 4] || (b[COUNT + 4]->size != 1) || (b[COUNT + 4]->data[0] != NUL);
+
+    calcDeleteSourceBuffers(b, COUNT + 5);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *point = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    const char *paths[COUNT + 5];
+    size_t i;
+    FILE *f;
+
+    int failed = 0;
+
+    for (i = 0; i < COUNT; i++)
+    {
+        sprintf(names[i], TEMP("%u"), (unsigned)i);
+
+        if ((f = fopen(names[i], "wb")))
+        {
+            fprintf(f, "let x%u = %u;\n", (unsigned)i, (unsigned)(i * i));
+            fclose(f);
+        }
+
+        paths[i] = names[i];
+    }
+
+    if ((f = fopen(TEMP("empty"), "wb")))
+        fclose(f);
+
+    // Missing files (and missing paths) are left NULL, as the files that are
+    // not regular (the temporary directory).
+    paths[COUNT] = TEMP("missing");
+    paths[COUNT + 1] = NULL;
+    paths[COUNT + 2] = PATH;
+    paths[COUNT + 3] = CALC_TEMP_PATH;
+    paths[COUNT + 4] = TEMP("empty");
+
+    failed |= check(paths, 1, point);
+    failed |= check(paths, 8, point);
+    failed |= check(paths, 0, point);
+
+    for (i = 0; i < COUNT; i++)
+        remove(names[i]);
+
+    remove(TEMP("empty"));
+
+    calcDeleteSourceBuffer(point);
+
+    return failed;
+}
@@ -0,0 +1,114 @@
+#include "calc/base/string.h"
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define COUNT 4096
+
+typedef struct _Text
+{
+    const char *data;
+    size_t      position;
+} Text_t;
+
+static CalcSourceLocation_t expected[COUNT];
+static size_t length;
+
+static size_t CALC_STDCALL readText(void *context, byte_t *buffer, size_t count)
+{
+    Text_t *text = (Text_t *)context;
+
+    count = min(count, strlen(text->data + text->position));
+    memcpy(buffer, text->data + text->position, count);
+    text->position += count;
+
+    return count;
+}
+
+// Reads the stream alternating spans and characters, checking each location.
+static int check(CalcSourceStream_t *const s, bool_t isLazy)
+{
+    CalcSourceLocation_t l;
+    CalcSourceSpan_t span;
+    size_t i = 0;
+
+    int failed = !calcSetSourceStreamLazyLocations(s, isLazy);
+
+    while (!failed && (calcSourceStreamPeek(s) != EOF) && (calcSourceStreamPeek(s) != NUL))
+    {
+        if (!calcSourceStreamReadWhile(s, CALC_SOURCE_CLASS_IDENTIFIER, &span))
+            calcSourceStreamRead(s);
+
+        while ((i < length) && (expected[i].ch < s->forwardLocation.ch))
+            i++;
+
+        l = s->forwardLocation;
+
+        failed |= (i == length) || (expected[i].ch != l.ch);
+        failed |= !calcSourceStreamResolveLocation(s, &l) || (l.ln != expected[i].ln) || (l.co != expected[i].co);
+        failed |= !isLazy && ((s->forwardLocation.ln != expected[i].ln) || (s->forwardLocation.co != expected[i].co));
+        failed |= isLazy && (s->forwardLocation.ln || s->forwardLocation.co);
+
+        calcSourceStreamBeginLexeme(s);
+    }
+
+    failed |= calcSetSourceStreamLazyLocations(s, !isLazy);
+
+    calcDeleteSourceStream(s);
+
+    return failed;
+}
+
+static int checkText(const char *const data)
+{
+    CalcSourceStream_t *s = calcCreateSourceStreamFromText(data, CALC_SOURCE_ENCODING_UTF_8);
+    Text_t text;
+
+    int failed = 0;
+
+    // The expected locations, reading character by character.
+    length = 0;
+
+    do
+        expected[length++] = s->forwardLocation;
+    while ((length < COUNT) && (calcSourceStreamRead(s) > 0));
+
+    calcDeleteSourceStream(s);
+
+    failed |= check(calcCreateSourceStreamFromText(data, CALC_SOURCE_ENCODING_UTF_8), FALSE);
+    failed |= check(calcCreateSourceStreamFromText(data, CALC_SOURCE_ENCODING_UTF_8), TRUE);
+
+    text.data = data, text.position = 0;
+    s = calcOpenSourceStreamFromReader("<text>", readText, &text, CALC_SOURCE_ENCODING_UTF_8);
+    calcSetSourceStreamRefillSize(s, 16);
+    failed |= check(s, FALSE);
+
+    text.data = data, text.position = 0;
+    s = calcOpenSourceStreamFromReader("<text>", readText, &text, CALC_SOURCE_ENCODING_UTF_8);
+    calcSetSourceStreamRefillSize(s, 16);
+    failed |= check(s, TRUE);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceStream_t *s = calcCreateSourceStreamFromText("\xC3\xA0\xE2\x82\xAC" "b\n\xF0\x9F\x98\x80", CALC_SOURCE_ENCODING_UTF_8);
+
+    int failed = 0;
+
+    // Columns are characters, not bytes.
+    calcSourceStreamRead(s), failed |= (s->forwardLocation.co != 1) || (s->forwardLocation.ch != 2);
+    calcSourceStreamRead(s), failed |= (s->forwardLocation.co != 2) || (s->forwardLocation.ch != 5);
+    calcSourceStreamRead(s), calcSourceStreamRead(s), calcSourceStreamRead(s);
+    failed |= (s->forwardLocation.ln != 1) || (s->forwardLocation.co != 1) || (s->forwardLocation.ch != 11);
+    calcDeleteSourceStream(s);
+
+    failed |= checkText((const char *)b->data);
+    failed |= checkText("let \xC3\xA0\xC3\xA8 = \"\xE2\x82\xAC\";\n\n// \xF0\x9F\x98\x80 \xF0\x9F\x98\x80 \xF0\x9F\x98\x80\nlet \xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB\xCE\xBB = 0;\n");
+
+    calcDeleteSourceBuffer(b);
+
+    return failed;
+}
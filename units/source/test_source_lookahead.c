@@ -0,0 +1,53 @@
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+#define DEPTH (CALC_SOURCE_STREAM_LOOKAHEAD + 4)
+
+static int check(CalcSourceStream_t *const s, CalcSourceStream_t *const r)
+{
+    int32_t expected[DEPTH];
+    uint32_t i, k = 0;
+
+    int failed = 0;
+
+    // r is read DEPTH characters ahead of s.
+    for (i = 0; i < DEPTH; i++)
+        expected[i] = calcSourceStreamRead(r);
+
+    while (!failed && (expected[k % DEPTH] != EOF))
+    {
+        for (i = 0; i < DEPTH; i++)
+            failed |= (calcSourceStreamPeekOffset(s, i) != expected[(k + i) % DEPTH]);
+
+        failed |= (calcSourceStreamRead(s) != expected[k % DEPTH]);
+
+        calcSourceStreamBeginLexeme(s);
+        calcSourceStreamBeginLexeme(r);
+
+        expected[k++ % DEPTH] = calcSourceStreamRead(r);
+    }
+
+    failed |= (s->forwardLocation.ch != r->forwardLocation.ch);
+
+    calcDeleteSourceStream(s);
+    calcDeleteSourceStream(r);
+
+    return failed;
+}
+
+int main()
+{
+    static const char *const text = "a?.b...c<-d #!\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 x";
+
+    CalcSourceStream_t *s = calcOpenSourceStream(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8);
+
+    int failed = 0;
+
+    calcSetSourceStreamRefillSize(s, 16);
+
+    failed |= check(calcCreateSourceStreamFromText(text, CALC_SOURCE_ENCODING_UTF_8), calcCreateSourceStreamFromText(text, CALC_SOURCE_ENCODING_UTF_8));
+    failed |= check(s, calcOpenSourceStream(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8));
+
+    return failed;
+}
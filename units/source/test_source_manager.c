@@ -0,0 +1,26 @@
+#include "calc/source/source_manager.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+int main()
+{
+    CalcSourceManager_t *m = calcCreateSourceManager();
+    CalcSourceEntry_t *a = calcSourceManagerLoadFile(m, PATH, FALSE);
+    CalcSourceEntry_t *b = calcSourceManagerAdd(m, "<text>", FALSE, calcCreateSourceBufferFromText("first\nsecond line\n"));
+    CalcSourceLine_t l;
+    const char *path;
+    size_t offset;
+
+    int failed = !a || !b || (b->base != (a->base + a->buffer->size));
+
+    failed |= calcSourceManagerFind(m, CALC_SOURCE_INVALID_LOC, NULL) != NULL;
+    failed |= calcSourceManagerFind(m, a->base, &offset) != a || offset;
+    failed |= calcSourceManagerFind(m, b->base - 1, &offset) != a || (offset != (a->buffer->size - 1));
+    failed |= calcSourceManagerFind(m, b->base + (CalcSourceLoc_t)b->buffer->size, NULL) != NULL;
+
+    failed |= !calcSourceManagerDecode(m, calcGetSourceLoc(b, 8), &path, &l) || strcmp(path, "<text>") || (l.ln != 1) || (l.co != 2) || (l.length != 11);
+
+    calcDeleteSourceManager(m);
+
+    return failed;
+}
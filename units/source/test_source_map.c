@@ -0,0 +1,77 @@
+#include "calc/base/string.h"
+#include "calc/source/source_buffer.h"
+
+#define PATH CALC_TEMP_PATH "/test_source_map.tmp"
+
+#define SIZE ((CALC_PAGESIZ * 3) + 5)
+
+static byte_t content[SIZE];
+
+static int save(const byte_t *const data, size_t count)
+{
+    FILE *f = fopen(PATH, "wb");
+
+    if (!f)
+        return 1;
+
+    fwrite(data, sizeof(byte_t), count, f);
+    fclose(f);
+
+    return 0;
+}
+
+// Maps the content and compares it byte by byte, then validates it on demand.
+static int check(size_t count, bool_t isValid, size_t invalidOffset)
+{
+    CalcSourceBuffer_t *b;
+
+    int failed = 0;
+
+    if (save(content, count) || !(b = calcCreateSourceBufferFromMappedFile(PATH, CALC_SOURCE_ENCODING_UTF_8)))
+        return 1;
+
+    failed |= !b->isMapped || b->isValidated || (b->size != (count + 1)) || memcmp(b->data, content, count) || (b->data[count] != NUL);
+    failed |= (calcValidateSourceBuffer(b) != isValid) || (b->isValidated != isValid) || (b->invalidOffset != invalidOffset);
+
+    calcDeleteSourceBuffer(b);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *b;
+    size_t i;
+
+    int failed = 0;
+
+    // Lines of ASCII and multibyte characters over many pages.
+    for (i = 0; i < SIZE; i++)
+        content[i] = ((i % 40) == 39) ? EOL : (byte_t)('a' + (i % 26));
+
+    memcpy(content + 100, "\xC3\xA9\xE2\x82\xAC", 5);
+
+    failed |= check(SIZE, TRUE, SIZE);
+    failed |= check(CALC_PAGESIZ, TRUE, CALC_PAGESIZ);
+    failed |= check(0, TRUE, 0);
+
+    content[SIZE - 3] = 0xFF;
+    failed |= check(SIZE, FALSE, SIZE - 3);
+
+    // A BOM is removed, so the content is copied and validated.
+    if (save((const byte_t *)"\xEF\xBB\xBFlet \xC3\xA9", 9) || !(b = calcCreateSourceBufferFromMappedFile(PATH, CALC_SOURCE_ENCODING_ASCII)))
+    {
+        failed = 1;
+    }
+    else
+    {
+        failed |= b->isMapped || !b->isValidated || (b->encoding != CALC_SOURCE_ENCODING_UTF_8) || strcmp((const char *)b->data, "let \xC3\xA9");
+        calcDeleteSourceBuffer(b);
+    }
+
+    failed |= (calcCreateSourceBufferFromMappedFile(CALC_TEMP_PATH, CALC_SOURCE_ENCODING_UTF_8) != NULL);
+
+    remove(PATH);
+
+    return failed;
+}
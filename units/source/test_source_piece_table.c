@@ -0,0 +1,95 @@
+#include "calc/source/source_piece_table.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+static char text[4096], last[4096];
+static size_t length;
+
+static int check(CalcSourcePieceTable_t *const t)
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromPieceTable(t);
+    CalcSourceStream_t *s;
+    CalcSourceRange_t range;
+    size_t i, lastLength = strlen(last);
+    int32_t c;
+
+    int failed = (b->size != (length + 1)) || memcmp(b->data, text, length);
+
+    // Only the bytes in the changed range differ from the previous content.
+    if (calcSourcePieceTableTakeChanges(t, &range))
+    {
+        failed |= (range.begin > range.end) || (range.end > length);
+        failed |= memcmp(text, last, range.begin) || memcmp(text + range.end, last + lastLength - (length - range.end), length - range.end);
+
+        s = calcOpenSourceStreamFromPieceTable(t, range.begin, CALC_SOURCE_ENCODING_UTF_8);
+        calcSetSourceStreamRefillSize(s, 16);
+
+        for (i = range.begin; !failed && (i < length); i++)
+            failed |= ((c = calcSourceStreamRead(s)) != text[i]);
+
+        failed |= (calcSourceStreamPeek(s) != EOF) && (calcSourceStreamPeek(s) != NUL);
+
+        calcDeleteSourceStream(s);
+    }
+
+    strcpy(last, text);
+    calcDeleteSourceBuffer(b);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourcePieceTable_t *t;
+    CalcSourceSpan_t span;
+    size_t i, j, offset, count;
+
+    int failed = 0;
+
+    strcpy(text, (const char *)b->data);
+    strcpy(last, text);
+    length = strlen(text);
+
+    t = calcCreateSourcePieceTable(b);
+    srand(16);
+
+    for (i = 0; !failed && (i < 2000); i++)
+    {
+        // A few edits are applied before checking the changed range.
+        for (j = 0; j < (size_t)(1 + (rand() % 3)); j++)
+        {
+            offset = (size_t)rand() % (length + 1);
+
+            if ((rand() & 1) && ((length + 16) < sizeof(text)))
+            {
+                count = 1 + ((size_t)rand() % 8);
+                memmove(text + offset + count, text + offset, length - offset + 1);
+                memset(text + offset, 'a' + (rand() % 26), count);
+                failed |= !calcSourcePieceTableInsert(t, offset, (const byte_t *)text + offset, count);
+                length += count;
+            }
+            else
+            {
+                count = (size_t)rand() % 8;
+                count = min(count, length - offset);
+                memmove(text + offset, text + offset + count, length - offset - count + 1);
+                failed |= !calcSourcePieceTableDelete(t, offset, count);
+                length -= count;
+            }
+        }
+
+        failed |= check(t);
+    }
+
+    // Spans are contiguous up to the end of their piece.
+    for (i = 0; !failed && (i < length); i += span.length)
+        failed |= !calcSourcePieceTableGetSpan(t, i, &span) || memcmp(span.data, text + i, span.length);
+
+    failed |= calcSourcePieceTableGetSpan(t, length, &span) != 0;
+    failed |= calcSourcePieceTableInsert(t, length + 1, (const byte_t *)"x", 1) || calcSourcePieceTableDelete(t, length, 1);
+
+    calcDeleteSourcePieceTable(t);
+
+    return failed;
+}
@@ -0,0 +1,43 @@
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+static int drain(CalcSourceStream_t *const s, size_t length)
+{
+    size_t i = 0;
+
+    while (calcSourceStreamRead(s) > 0)
+        i++;
+
+    calcDeleteSourceStream(s);
+
+    return i != length;
+}
+
+int main()
+{
+    static const char *const snippets[] = {"let x = 1;", "let y = x + 2;\nlet z = y * x;", "fun f(a, b) = a + b;"};
+
+    CalcSourcePool_t *p = calcCreateSourcePool();
+    size_t i, allocations;
+
+    int failed = 0;
+
+    // After the first round each stream and buffer is recycled.
+    for (i = 0; i < 3000; i++)
+        failed |= drain(calcCreatePooledSourceStreamFromText(p, snippets[i % 3], CALC_SOURCE_ENCODING_UTF_8), strlen(snippets[i % 3]));
+
+    failed |= (p->allocations != 2) || (p->reuses != 5998) || (p->releases != 6000);
+
+    allocations = p->allocations;
+
+    for (i = 0; i < 100; i++)
+        failed |= drain(calcCreatePooledSourceStreamFromFile(p, PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8), 524);
+
+    // Point.calc needs a larger size class.
+    failed |= (p->allocations != (allocations + 1));
+
+    calcDeleteSourcePool(p);
+
+    return failed;
+}
@@ -0,0 +1,95 @@
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_TEMP_PATH "/test_source_prefetch.tmp"
+
+#define SIZE (256 * 1024)
+
+#define REFILL 16
+
+static CalcSourceStream_t *openPrefetched(size_t segmentCount)
+{
+    CalcSourceStream_t *s = calcOpenSourceStream(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8);
+
+    if (!s)
+        return NULL;
+
+    // The segments have the refill size, it's set before prefetching.
+    calcSetSourceStreamRefillSize(s, REFILL);
+
+    if (!calcSourceStreamEnablePrefetch(s, segmentCount))
+    {
+        calcDeleteSourceStream(s);
+
+        return NULL;
+    }
+
+    return s;
+}
+
+int main()
+{
+    CalcSourceStream_t *s;
+    CalcSourceSpan_t span;
+    byte_t *data = (byte_t *)cmalloc(SIZE);
+    size_t position, count, i;
+    FILE *f;
+    int failed = 0;
+
+    // Lines of a length prime to the refill size, so EOLs fall everywhere in
+    // the segments.
+    for (i = 0; i < SIZE; i++)
+        data[i] = ((i % 61) == 60) ? EOL : (byte_t)('a' + (i % 26));
+
+    if (!(f = fopen(PATH, "wb")))
+    {
+        free(data);
+
+        return 1;
+    }
+
+    fwrite(data, 1, SIZE, f);
+    fclose(f);
+
+    // Thousands of refills through a queue of few segments, read in spans of
+    // a size prime to the refill size: the bytes are the same of the file.
+    if (!(s = openPrefetched(4)))
+        failed = 1;
+    else
+    {
+        for (position = 0; (count = calcSourceStreamReadBytes(s, 7, &span)) != 0; position += count)
+        {
+            if (((position + count) > SIZE) || memcmp(span.data, data + position, count))
+            {
+                failed = 1;
+                break;
+            }
+        }
+
+        failed |= (position != SIZE) || s->isOverflowed;
+
+        calcDeleteSourceStream(s);
+    }
+
+    // Deleted while the helper thread is reading ahead: it's stopped and
+    // joined before the segments are freed.
+    for (i = 0; i < 16; i++)
+    {
+        if (!(s = openPrefetched(1024)))
+        {
+            failed = 1;
+            break;
+        }
+
+        count = calcSourceStreamReadBytes(s, 1, &span);
+        failed |= (count != 1) || (span.data[0] != data[0]);
+
+        calcDeleteSourceStream(s);
+    }
+
+    remove(PATH);
+    free(data);
+
+    return failed;
+}
@@ -0,0 +1,125 @@
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+#include "calc/base/utf8.h"
+#include "calc/source/source_stream.h"
+
+#include <time.h>
+
+#define CORPUS_SIZE (64 * 1024 * 1024)
+
+static char *makeCorpus(size_t size)
+{
+    static const char *const lines[] = {
+        "class Point {\n",
+        "    var x: Int = 0; // horizontal coordinate\n",
+        "    var y: Int = 0; // vertical coordinate\n",
+        "    fun move(dx: Int, dy: Int) { x += dx; y += dy; }\n",
+        "    // \xC3\xA0 \xE2\x82\xAC \xF0\x9F\x98\x80\n",
+        "}\n",
+    };
+
+    char *corpus = (char *)cmalloc(size + 1);
+    size_t i = 0, j = 0, n;
+
+    while (i < size)
+    {
+        n = min(strlen(lines[j]), size - i);
+
+        memcpy(corpus + i, lines[j], n);
+
+        i += n;
+        j = (j + 1) % (sizeof(lines) / sizeof(*lines));
+    }
+
+    corpus[size] = NUL;
+
+    return corpus;
+}
+
+// Reads the corpus as a lexer does, in spans of whitespaces and identifiers.
+static double readSpans(const char *const corpus, bool_t isLazy)
+{
+    CalcSourceStream_t *s = calcCreateSourceStreamFromText(corpus, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceSpan_t span;
+    size_t length = 0, count;
+
+    double T1, T2;
+
+    calcSetSourceStreamLazyLocations(s, isLazy);
+
+    T1 = (double)clock() / CLOCKS_PER_SEC;
+
+    while (calcSourceStreamPeek(s) > 0)
+    {
+        if ((count = calcSourceStreamReadWhile(s, CALC_SOURCE_CLASS_WHITESPACE | CALC_SOURCE_CLASS_IDENTIFIER, &span)))
+            length += count;
+        else
+            calcSourceStreamRead(s);
+
+        calcSourceStreamBeginLexeme(s);
+    }
+
+    T2 = (double)clock() / CLOCKS_PER_SEC;
+
+    calcDeleteSourceStream(s);
+
+    return !length ? 0.0 : (CORPUS_SIZE / 1048576.0) / (T2 - T1);
+}
+
+int main()
+{
+    char *corpus = makeCorpus(CORPUS_SIZE);
+
+    CalcSourceStream_t *s = calcCreateSourceStreamFromText(corpus, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceStream_t *l = calcCreateSourceStreamFromText(corpus, CALC_SOURCE_ENCODING_UTF_8);
+
+    const uint8_t *p = (const uint8_t *)corpus, *e = p + CORPUS_SIZE;
+    int32_t c, checksum1 = 0, checksum2 = 0, checksum3 = 0;
+    ssize_t n;
+
+    double T1, T2, dT1, dT2, dT3;
+
+    // Per-codepoint path: every character is decoded.
+    T1 = (double)clock() / CLOCKS_PER_SEC;
+
+    while ((p < e) && ((n = utf8_iterate(p, e - p, &c)) > 0))
+        checksum1 += c, p += n;
+
+    T2 = (double)clock() / CLOCKS_PER_SEC;
+
+    dT1 = T2 - T1;
+
+    // Source stream path: ASCII runs are not decoded.
+    T1 = (double)clock() / CLOCKS_PER_SEC;
+
+    while ((c = calcSourceStreamRead(s)) > 0)
+        checksum2 += c, calcSourceStreamBeginLexeme(s);
+
+    T2 = (double)clock() / CLOCKS_PER_SEC;
+
+    dT2 = T2 - T1;
+
+    // Lazy source stream path: only byte offsets are tracked.
+    calcSetSourceStreamLazyLocations(l, TRUE);
+
+    T1 = (double)clock() / CLOCKS_PER_SEC;
+
+    while ((c = calcSourceStreamRead(l)) > 0)
+        checksum3 += c, calcSourceStreamBeginLexeme(l);
+
+    T2 = (double)clock() / CLOCKS_PER_SEC;
+
+    dT3 = T2 - T1;
+
+    printf("utf8_iterate:         %8.2f MB/s\n", (CORPUS_SIZE / 1048576.0) / dT1);
+    printf("calcSourceStreamRead: %8.2f MB/s\n", (CORPUS_SIZE / 1048576.0) / dT2);
+    printf("lazy locations:       %8.2f MB/s\n", (CORPUS_SIZE / 1048576.0) / dT3);
+    printf("spans:                %8.2f MB/s\n", readSpans(corpus, FALSE));
+    printf("lazy spans:           %8.2f MB/s\n", readSpans(corpus, TRUE));
+
+    calcDeleteSourceStream(s);
+    calcDeleteSourceStream(l);
+    free(corpus);
+
+    return (checksum1 != checksum2) || (checksum1 != checksum3);
+}
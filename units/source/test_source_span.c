@@ -0,0 +1,52 @@
+#include "calc/source/source_lines.h"
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_CURRENT_PATH "/docs/examples/Point.calc"
+
+static int check(CalcSourceStream_t *const s, const CalcSourceBuffer_t *const b)
+{
+    CalcSourceSpan_t span;
+    size_t i = 0;
+    int32_t c;
+
+    int failed = 0;
+
+    while (!failed && (i < (b->size - 1)))
+    {
+        if (calcSourceStreamReadWhile(s, CALC_SOURCE_CLASS_WHITESPACE, &span) || calcSourceStreamReadWhile(s, CALC_SOURCE_CLASS_IDENTIFIER, &span))
+            ;
+        else if (calcSourceStreamPeek(s) == '/')
+            calcSourceStreamReadUntil(s, EOL, &span);
+        else
+            span.data = b->data + i, span.length = 1, failed |= ((c = calcSourceStreamRead(s)) != b->data[i]);
+
+        failed |= !span.length || memcmp(span.data, b->data + i, span.length);
+        i += span.length;
+
+        calcSourceStreamBeginLexeme(s);
+    }
+
+    failed |= (calcSourceStreamPeek(s) != EOF) && (calcSourceStreamPeek(s) != NUL);
+    failed |= (s->forwardLocation.ch != i) || ((s->forwardLocation.ln + 1) != calcGetSourceLines((CalcSourceBuffer_t *)b)->count);
+
+    calcDeleteSourceStream(s);
+
+    return failed;
+}
+
+int main()
+{
+    CalcSourceBuffer_t *b = calcCreateSourceBufferFromFile(PATH, CALC_SOURCE_ENCODING_UTF_8);
+    CalcSourceStream_t *s = calcOpenSourceStream(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8);
+
+    int failed = 0;
+
+    calcSetSourceStreamRefillSize(s, 16);
+
+    failed |= check(s, b);
+    failed |= check(calcCreateSourceStreamFromFile(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_8), b);
+
+    calcDeleteSourceBuffer(b);
+
+    return failed;
+}
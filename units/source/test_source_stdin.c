@@ -0,0 +1,80 @@
+#include "calc/base/alloc.h"
+#include "calc/base/string.h"
+#include "calc/source/source_buffer.h"
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_TEMP_PATH "/test_source_stdin.tmp"
+
+#define LINE ((3 * CALC_PAGESIZ) + 17)
+
+#define SIZE (LINE + 7)
+
+int main()
+{
+    CalcSourceBuffer_t *b;
+    CalcSourceStream_t *s;
+    CalcSourceSpan_t span;
+    byte_t *data = (byte_t *)cmalloc(SIZE);
+    size_t position, count, i;
+    FILE *f;
+    int failed = 0;
+
+    // A line longer than the first allocation of the buffer and than the ring
+    // of the stream, with NULs in it, then a short line.
+    for (i = 0; i < LINE; i++)
+        data[i] = ((i % 97) == 96) ? NUL : (byte_t)('a' + (i % 26));
+
+    data[LINE - 1] = EOL;
+    memcpy(data + LINE, "short\n", SIZE - LINE);
+
+    if (!(f = fopen(PATH, "wb")))
+    {
+        free(data);
+
+        return 1;
+    }
+
+    fwrite(data, 1, SIZE, f);
+    fclose(f);
+
+    if (!freopen(PATH, "rb", stdin))
+    {
+        remove(PATH);
+        free(data);
+
+        return 1;
+    }
+
+    // Stdin isn't a terminal, it's read in blocks into a buffer that doubles
+    // its size: it has the whole content, NULs too.
+    b = calcCreateSourceBufferFromStdin();
+    failed |= (b->size != (SIZE + 1)) || memcmp(b->data, data, SIZE) || (b->data[SIZE] != NUL);
+
+    calcDeleteSourceBuffer(b);
+
+    // A terminal can't be had here, so the stream is made interactive to read
+    // stdin line by line: the long line takes many refills of the ring.
+    rewind(stdin);
+
+    s = calcOpenStandardSourceStream();
+    s->isInteractive = TRUE;
+
+    for (position = 0; (count = calcSourceStreamReadBytes(s, 7, &span)) != 0; position += count)
+    {
+        if (((position + count) > SIZE) || memcmp(span.data, data + position, count))
+        {
+            failed = 1;
+            break;
+        }
+    }
+
+    failed |= (position != SIZE) || s->isOverflowed;
+
+    // Deleting the stream closes stdin.
+    calcDeleteSourceStream(s);
+
+    remove(PATH);
+    free(data);
+
+    return failed;
+}
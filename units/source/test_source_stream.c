@@ -5,7 +5,7 @@
 
 int main()
 {
-    CalcSourceStream_t *s = calcOpenSourceStream(CALC_CURRENT_PATH "/docs/examples/f.calc", FALSE, CALC_DEFAULT_ENCODING);
+    CalcSourceStream_t *s = calcOpenSourceStream(CALC_CURRENT_PATH "/docs/examples/Point.calc", FALSE, CALC_DEFAULT_ENCODING);
 
     int32_t t;
 
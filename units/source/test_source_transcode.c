@@ -0,0 +1,148 @@
+#include "calc/base/string.h"
+#include "calc/source/source_stream.h"
+
+#define PATH CALC_TEMP_PATH "/test_source_transcode.tmp"
+
+#define ASCII "0123456789abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJ"
+
+static int save(const byte_t *const content, size_t count)
+{
+    FILE *f = fopen(PATH, "wb");
+
+    if (!f)
+        return 1;
+
+    fwrite(content, sizeof(byte_t), count, f);
+    fclose(f);
+
+    return 0;
+}
+
+static size_t utf16le(byte_t *const buf, const uint16_t *const units, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+        buf[i << 1] = (byte_t)(units[i] & 0xFF), buf[(i << 1) + 1] = (byte_t)(units[i] >> 8);
+
+    return count << 1;
+}
+
+static int check(const byte_t *const content, size_t count, CalcSourceEncoding_t encoding, const char *const expected, CalcSourceEncoding_t detected)
+{
+    CalcSourceBuffer_t *b;
+    FILE *f;
+
+    int failed = 0;
+
+    if (save(content, count))
+        return 1;
+
+    // Both the mapped and the loaded files are transcoded, mappings that are
+    // not copied are validated on demand.
+    b = calcCreateSourceBufferFromFile(PATH, encoding);
+    failed |= !b || (b->size != (strlen(expected) + 1)) || strcmp((const char *)b->data, expected) || (b->encoding != detected) || (!b->isValidated && !(b->isMapped && calcValidateSourceBuffer(b)));
+    calcDeleteSourceBuffer(b);
+
+    if ((f = fopen(PATH, "rb")))
+    {
+        b = calcCreateSourceBufferFromStream(f, encoding);
+        failed |= (b->size != (strlen(expected) + 1)) || strcmp((const char *)b->data, expected) || (b->encoding != detected) || !b->isValidated;
+        calcDeleteSourceBuffer(b);
+        fclose(f);
+    }
+    else
+    {
+        failed = 1;
+    }
+
+    return failed;
+}
+
+// Opens the content as a stream with a small refill size, so the ring wraps
+// after the bytes read by the BOM sniffing.
+static int stream(const byte_t *const content, size_t count, CalcSourceEncoding_t encoding, const char *const expected, bool_t isOpen)
+{
+    CalcSourceStream_t *s;
+    CalcSourceSpan_t span;
+    size_t position = 0, n;
+
+    int failed = 0;
+
+    if (save(content, count) || !(s = calcOpenSourceStream(PATH, FALSE, encoding)))
+        return 1;
+
+    calcSetSourceStreamRefillSize(s, 16);
+
+    while ((n = calcSourceStreamReadBytes(s, 5, &span)) != 0)
+    {
+        failed |= ((position + n) > strlen(expected)) || memcmp(span.data, expected + position, n);
+
+        if (failed)
+            break;
+
+        position += n;
+    }
+
+    failed |= (position != strlen(expected)) || (s->isOpen != isOpen) || (s->encoding != CALC_SOURCE_ENCODING_UTF_8);
+
+    calcDeleteSourceStream(s);
+
+    return failed;
+}
+
+int main()
+{
+    static const uint16_t text[] = {0xFEFF, 'l', 'e', 't', ' ', 0x00E9, 0xD83D, 0xDE00, EOL};
+    static const uint16_t broken[] = {0xD800, 'x', 0xDC00};
+    static const int32_t chars[] = {'l', 'e', 't', ' ', 0x00E9, 0x1F600, EOL, NUL, EOF};
+
+    byte_t content[256];
+    uint16_t unit;
+    size_t count, i;
+    CalcSourceStream_t *s;
+
+    int failed = 0;
+
+    count = utf16le(content, text, countof(text));
+
+    // The run of ASCII code units is narrowed in blocks.
+    for (i = 0; i < strlen(ASCII); i++)
+        unit = (uint16_t)ASCII[i], count += utf16le(content + count, &unit, 1);
+
+    count += utf16le(content + count, broken, countof(broken));
+    content[count++] = 'y';
+
+    failed |= check(content, count, CALC_SOURCE_ENCODING_UTF_8, "let \xC3\xA9\xF0\x9F\x98\x80\n" ASCII "\xEF\xBF\xBDx\xEF\xBF\xBD\xEF\xBF\xBD", CALC_SOURCE_ENCODING_UTF_16LE);
+    failed |= check((const byte_t *)"caf\xE9 \xFF " ASCII, 7 + strlen(ASCII), CALC_SOURCE_ENCODING_LATIN_1, "caf\xC3\xA9 \xC3\xBF " ASCII, CALC_SOURCE_ENCODING_LATIN_1);
+    failed |= check((const byte_t *)"\xEF\xBB\xBFlet", 6, CALC_SOURCE_ENCODING_LATIN_1, "let", CALC_SOURCE_ENCODING_UTF_8);
+    failed |= check((const byte_t *)"let \xC3\xA9", 6, CALC_SOURCE_ENCODING_UTF_8, "let \xC3\xA9", CALC_SOURCE_ENCODING_UTF_8);
+
+    // Streams only read the transcoded characters.
+    if (save(content, utf16le(content, text, countof(text))) || !(s = calcOpenSourceStream(PATH, FALSE, CALC_SOURCE_ENCODING_UTF_16LE)))
+    {
+        failed = 1;
+    }
+    else
+    {
+        for (i = 0; i < countof(chars); i++)
+            failed |= (calcSourceStreamRead(s) != chars[i]);
+
+        failed |= (s->encoding != CALC_SOURCE_ENCODING_UTF_8);
+
+        calcDeleteSourceStream(s);
+    }
+
+    // The BOM of open streams is sniffed whatever the declared encoding: an
+    // UTF-16LE file is loaded whole, an UTF-8 BOM is skipped and the other
+    // bytes are read as they are.
+    failed |= stream(content, utf16le(content, text, countof(text)), CALC_SOURCE_ENCODING_UTF_8, "let \xC3\xA9\xF0\x9F\x98\x80\n", FALSE);
+    failed |= stream((const byte_t *)"\xEF\xBB\xBF" ASCII, 3 + strlen(ASCII), CALC_SOURCE_ENCODING_ASCII, ASCII, TRUE);
+    failed |= stream((const byte_t *)"\xEF\xBB\xBF", 3, CALC_SOURCE_ENCODING_UTF_8, "", TRUE);
+    failed |= stream((const byte_t *)"l\xC3\xA9" ASCII, 3 + strlen(ASCII), CALC_SOURCE_ENCODING_UTF_8, "l\xC3\xA9" ASCII, TRUE);
+    failed |= stream((const byte_t *)"\xFF", 1, CALC_SOURCE_ENCODING_UTF_8, "\xFF", TRUE);
+
+    remove(PATH);
+
+    return failed;
+}
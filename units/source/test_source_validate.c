@@ -0,0 +1,45 @@
+#include "calc/source/source_buffer.h"
+#include "calc/base/utf8.h"
+
+static int check(const char *const text, bool_t isValid, size_t invalidOffset)
+{
+    CalcSourceBuffer_t *s = calcCreateSourceBufferFromText(text);
+
+    int failed = (s->isValidated != isValid) || (s->invalidOffset != invalidOffset);
+
+    uint64_t i = 0;
+    int32_t c, e;
+    ssize_t n, m;
+
+    // Validated buffers must decode the same characters as utf8_iterate.
+    while (!failed && isValid && ((c = calcSourceBufferGetChar(s, CALC_SOURCE_ENCODING_UTF_8, i, &n)) > 0))
+    {
+        m = utf8_iterate(s->data + i, (ssize_t)(s->size - i), &e);
+
+        failed = (c != e) || (n != m);
+        i += n;
+    }
+
+    if (failed)
+        fprintf(stderr, "failed: \"%s\"\n", text);
+
+    calcDeleteSourceBuffer(s);
+
+    return failed;
+}
+
+int main()
+{
+    int failed = 0;
+
+    failed |= check("", TRUE, 0);
+    failed |= check("let x = 1; // plain ASCII text, longer than a SIMD block", TRUE, 56);
+    failed |= check("\xC3\xA0 \xE2\x82\xAC \xF0\x9F\x98\x80 \xF4\x8F\xBF\xBF", TRUE, 16);
+    failed |= check("abcdefghijklmnopqrstuvwxyz0123456789\x80", FALSE, 36);
+    failed |= check("ab\xC0\xAF", FALSE, 2);             // overlong
+    failed |= check("ab\xED\xA0\x80", FALSE, 2);         // surrogate
+    failed |= check("ab\xF4\x90\x80\x80", FALSE, 2);     // above U+10FFFF
+    failed |= check("ab\xE2\x82", FALSE, 2);             // truncated
+
+    return failed;
+}